@@ -0,0 +1,111 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "BloomFilter.h"
+#include "Hash.h"
+
+#define BLOOM_BLOCK_BITS (BLOOM_BLOCK_WORDS * 64)
+#define CACHE_LINE 64
+
+bool init_bloom_filter(BloomFilter* filter, size_t expected_items, double false_positive_rate) {
+    if (!filter) return false;
+    if (expected_items == 0) expected_items = 1;
+    if (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)) return false;
+
+    // Textbook sizing: m = -n ln p / (ln 2)^2 bits and k = m / n * ln 2 hashes
+    double ln2 = log(2.0);
+    double bits = -(double)expected_items * log(false_positive_rate) / (ln2 * ln2);
+    double hashes = bits / (double)expected_items * ln2;
+
+    *filter = (BloomFilter){0};
+    filter->block_count = (size_t)ceil(bits / BLOOM_BLOCK_BITS);
+    if (filter->block_count == 0) filter->block_count = 1;
+    filter->hash_count = (unsigned)(hashes + 0.5);
+    if (filter->hash_count < 1) filter->hash_count = 1;
+    if (filter->hash_count > BLOOM_MAX_HASHES) filter->hash_count = BLOOM_MAX_HASHES;
+
+    // Over-allocate by a line and round up, so no block straddles two lines
+    size_t bytes = filter->block_count * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    filter->memory = calloc(1, bytes + CACHE_LINE);
+    if (!filter->memory) return false;
+    filter->blocks = (uint64_t*)(((uintptr_t)filter->memory + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1));
+    filter->seed = random_hash_seed();
+    filter->expected_items = expected_items;
+    filter->false_positive_rate = false_positive_rate;
+
+    return true;
+}
+
+void free_bloom_filter(BloomFilter* filter) {
+    if (!filter) return;
+    free(filter->memory);
+    *filter = (BloomFilter){0};
+}
+
+// One hash per key: scaled to the block count it picks the block, two
+// more mixes of it give the bit positions by double hashing
+static uint64_t* key_block(const BloomFilter* filter, const char* key, size_t len, uint32_t* h1, uint32_t* h2) {
+    uint32_t hash = word64_hash(key, len, filter->seed);
+    *h1 = hash_displace(hash, 1);
+    *h2 = hash_displace(hash, 2) | 1;   // Odd, so the positions do not repeat early
+    size_t block = (size_t)(((uint64_t)hash * filter->block_count) >> 32);
+    return &filter->blocks[block * BLOOM_BLOCK_WORDS];
+}
+
+void bloom_filter_add(BloomFilter* filter, const char* key, size_t len) {
+    if (!filter || !filter->blocks) return;
+
+    uint32_t h1, h2;
+    uint64_t* block = key_block(filter, key, len, &h1, &h2);
+    for (unsigned i = 0; i < filter->hash_count; i++) {
+        uint32_t bit = (h1 + i * h2) % BLOOM_BLOCK_BITS;
+        block[bit / 64] |= 1ULL << (bit % 64);
+    }
+    filter->items++;
+}
+
+bool bloom_filter_may_contain(BloomFilter* filter, const char* key, size_t len) {
+    if (!filter || !filter->blocks) return true;
+
+    uint32_t h1, h2;
+    const uint64_t* block = key_block(filter, key, len, &h1, &h2);
+    filter->checks++;
+    for (unsigned i = 0; i < filter->hash_count; i++) {
+        uint32_t bit = (h1 + i * h2) % BLOOM_BLOCK_BITS;
+        if (!(block[bit / 64] & (1ULL << (bit % 64)))) {
+            filter->rejected++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void bloom_filter_report_false_positive(BloomFilter* filter) {
+    // Without blocks every check is a yes, none of them is the filter's mistake
+    if (filter && filter->blocks) filter->false_positives++;
+}
+
+double bloom_filter_false_positive_rate(const BloomFilter* filter) {
+    if (!filter || !filter->blocks) return 0.0;
+    size_t missing = filter->rejected + filter->false_positives;
+    return missing ? (double)filter->false_positives / (double)missing : 0.0;
+}
+
+double bloom_filter_expected_rate(const BloomFilter* filter) {
+    if (!filter || !filter->blocks) return 1.0;
+
+    // Share of set bits, every one of the k probes has to land on one
+    size_t set = 0;
+    size_t words = filter->block_count * BLOOM_BLOCK_WORDS;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word = filter->blocks[i];
+        while (word) {
+            word &= word - 1;
+            set++;
+        }
+    }
+    double fill = (double)set / (double)(words * 64);
+    return pow(fill, (double)filter->hash_count);
+}
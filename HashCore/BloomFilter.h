@@ -0,0 +1,44 @@
+#ifndef HASH_CORE_BLOOM_FILTER_H
+#define HASH_CORE_BLOOM_FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Blocked Bloom filter: every key sets and tests its bits inside one
+// 64 byte block, so a check costs one cache line no matter how many bits.
+// Never says no to a key that was added, may say yes to one that was not.
+#define BLOOM_BLOCK_WORDS 8          // 8 x 64 bits = one cache line
+#define BLOOM_MAX_HASHES 16
+
+typedef struct {
+    void* memory;                    // Allocation, blocks is this aligned to a cache line
+    uint64_t* blocks;
+    size_t block_count;
+    unsigned hash_count;             // Bits set per key
+    uint64_t seed;
+    size_t expected_items;           // What it was sized for, with false_positive_rate
+    double false_positive_rate;
+    size_t items;                    // Keys added
+    size_t checks;                   // bloom_filter_may_contain calls
+    size_t rejected;                 // ...that answered a definite no
+    size_t false_positives;          // Reported by the caller, see bloom_filter_report_false_positive
+} BloomFilter;
+
+// Sized for `expected_items` keys at `false_positive_rate` (0..1)
+bool init_bloom_filter(BloomFilter* filter, size_t expected_items, double false_positive_rate);
+void free_bloom_filter(BloomFilter* filter);
+
+void bloom_filter_add(BloomFilter* filter, const char* key, size_t len);
+bool bloom_filter_may_contain(BloomFilter* filter, const char* key, size_t len);
+
+// The caller looked a key up after a yes and did not find it, ignored
+// without a filter
+void bloom_filter_report_false_positive(BloomFilter* filter);
+
+// False positives over all checks for keys that were not there, 0 before any
+double bloom_filter_false_positive_rate(const BloomFilter* filter);
+// What the fill level predicts for the next check of a missing key
+double bloom_filter_expected_rate(const BloomFilter* filter);
+
+#endif //HASH_CORE_BLOOM_FILTER_H
@@ -0,0 +1,405 @@
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "Hash.h"
+
+// Seed sources, see random_hash_seed
+#if defined(_WIN32)
+#include <windows.h>
+#include <bcrypt.h>
+#elif defined(__linux__)
+#include <sys/random.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <stdlib.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#define HASH_LANES 8                 // Keys hashed side by side in jenkins_hash_batch
+#define HASH_BLOCK 64                // Keys grouped by length together
+#define HASH_LENGTH_BUCKETS 16
+
+/*
+ * Jenkins one-at-a-time hash function
+ * Parameters:
+ * - key: pointer to the input data
+ * - len: length of the input data in bytes
+ * Returns: 32-bit hash value
+ */
+
+uint32_t jenkins_hash(const void* key, size_t len)
+// key: A pointer to the data to be hashed (can be any type)
+// len: The length of the data in bytes
+// The function returns a 32-bit unsigned integer
+
+{
+    const uint8_t* data = (const uint8_t*)key;
+    // Converts the input pointer to a byte pointer
+    // This allows us to process the input data one byte at a time
+    // uint8_t ensures we're working with unsigned 8-bit integers
+
+    uint32_t hash = 0;
+    size_t i;
+
+    // Phase 1: Process each byte of input
+    for (i = 0; i < len; ++i) {
+        hash += data[i];           // Step 1: Add byte to hash
+        hash += (hash << 10);      // Step 2: Add hash shifted left by 10
+        hash ^= (hash >> 6);       // Step 3: XOR with hash shifted right by 6
+    }
+
+    // Phase 2: Avalanche effect - final mixing
+    hash += (hash << 3);           // Mix 1: Add hash shifted left by 3
+    hash ^= (hash >> 11);          // Mix 2: XOR with hash shifted right by 11
+    hash += (hash << 15);          // Mix 3: Add hash shifted left by 15
+
+    return hash;
+}
+
+/*
+ * Same steps as jenkins_hash, but the state starts from the seed instead of 0
+ * - seed: folded to 32 bits, 0 gives exactly jenkins_hash
+ * Without knowing the seed nobody can work out ahead of time a set of keys
+ * that all land in the same bucket.
+ */
+static uint32_t fold_seed(uint64_t seed) {
+    return (uint32_t)(seed ^ (seed >> 32));
+}
+
+uint32_t jenkins_hash_seeded(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* data = (const uint8_t*)key;
+    uint32_t hash = fold_seed(seed);
+
+    for (size_t i = 0; i < len; ++i) {
+        hash += data[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+
+    return hash;
+}
+
+/*
+ * Streaming form of the two functions above. The one-at-a-time state is a
+ * single 32-bit word that only depends on the bytes before it, so a chunk
+ * can end anywhere; final runs the avalanche on a copy and leaves the state
+ * open for more input.
+ * - seed: 0 matches jenkins_hash, anything else jenkins_hash_seeded
+ */
+void jenkins_hash_init(JenkinsHashState* state, uint64_t seed) {
+    state->hash = fold_seed(seed);
+    state->length = 0;
+}
+
+void jenkins_hash_update(JenkinsHashState* state, const void* chunk, size_t len) {
+    const uint8_t* data = (const uint8_t*)chunk;
+    uint32_t hash = state->hash;
+
+    for (size_t i = 0; i < len; ++i) {
+        hash += data[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+
+    state->hash = hash;
+    state->length += len;
+}
+
+uint32_t jenkins_hash_final(const JenkinsHashState* state) {
+    uint32_t hash = state->hash;
+
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+
+    return hash;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+/*
+ * Runs jenkins_hash on HASH_LANES keys side by side, one 32-bit lane per key
+ * - keys/lengths: HASH_LANES inputs, empty lanes have length 0
+ * - seed: starting state of every lane, see jenkins_hash_seeded
+ * - out: where each lane's hash is written
+ * A lane whose key already ended is masked so it keeps its value while the
+ * longer keys finish, which is why jenkins_hash_batch groups similar lengths.
+ */
+static void jenkins_hash_lanes(const uint8_t* const keys[], const uint32_t lengths[], uint32_t seed,
+                               uint32_t* const out[]) {
+    uint32_t longest = 0;
+    for (int lane = 0; lane < HASH_LANES; lane++) {
+        if (lengths[lane] > longest) longest = lengths[lane];
+    }
+
+    // Byte `pos` of a lane, finished lanes keep reading their last byte
+    // (a lane with length 0 points at a single zero byte)
+    uint32_t last[HASH_LANES];
+    for (int lane = 0; lane < HASH_LANES; lane++) {
+        last[lane] = lengths[lane] ? lengths[lane] - 1 : 0;
+    }
+#define LANE_BYTE(lane) ((int)keys[lane][pos < last[lane] ? pos : last[lane]])
+
+#if defined(__AVX2__)
+    __m256i hash = _mm256_set1_epi32((int)seed);
+    __m256i len = _mm256_loadu_si256((const __m256i*)lengths);
+
+    for (uint32_t pos = 0; pos < longest; pos++) {
+        __m256i bytes = _mm256_setr_epi32(LANE_BYTE(0), LANE_BYTE(1), LANE_BYTE(2), LANE_BYTE(3),
+                                          LANE_BYTE(4), LANE_BYTE(5), LANE_BYTE(6), LANE_BYTE(7));
+        __m256i active = _mm256_cmpgt_epi32(len, _mm256_set1_epi32((int)pos));
+
+        __m256i next = _mm256_add_epi32(hash, bytes);
+        next = _mm256_add_epi32(next, _mm256_slli_epi32(next, 10));
+        next = _mm256_xor_si256(next, _mm256_srli_epi32(next, 6));
+        hash = _mm256_blendv_epi8(hash, next, active);
+    }
+
+    hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 3));
+    hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 11));
+    hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 15));
+
+    uint32_t result[HASH_LANES];
+    _mm256_storeu_si256((__m256i*)result, hash);
+#else
+    // SSE2 only has 4 lanes, run two halves next to each other
+    __m128i hash[2] = {_mm_set1_epi32((int)seed), _mm_set1_epi32((int)seed)};
+    __m128i len[2] = {_mm_loadu_si128((const __m128i*)&lengths[0]),
+                      _mm_loadu_si128((const __m128i*)&lengths[4])};
+
+    for (uint32_t pos = 0; pos < longest; pos++) {
+        __m128i bytes[2] = {_mm_setr_epi32(LANE_BYTE(0), LANE_BYTE(1), LANE_BYTE(2), LANE_BYTE(3)),
+                            _mm_setr_epi32(LANE_BYTE(4), LANE_BYTE(5), LANE_BYTE(6), LANE_BYTE(7))};
+
+        for (int half = 0; half < 2; half++) {
+            __m128i active = _mm_cmpgt_epi32(len[half], _mm_set1_epi32((int)pos));
+
+            __m128i next = _mm_add_epi32(hash[half], bytes[half]);
+            next = _mm_add_epi32(next, _mm_slli_epi32(next, 10));
+            next = _mm_xor_si128(next, _mm_srli_epi32(next, 6));
+            hash[half] = _mm_or_si128(_mm_and_si128(active, next), _mm_andnot_si128(active, hash[half]));
+        }
+    }
+
+    uint32_t result[HASH_LANES];
+    for (int half = 0; half < 2; half++) {
+        __m128i h = hash[half];
+        h = _mm_add_epi32(h, _mm_slli_epi32(h, 3));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 11));
+        h = _mm_add_epi32(h, _mm_slli_epi32(h, 15));
+        _mm_storeu_si128((__m128i*)&result[half * 4], h);
+    }
+#endif
+#undef LANE_BYTE
+
+    for (int lane = 0; lane < HASH_LANES; lane++) {
+        *out[lane] = result[lane];
+    }
+}
+#endif
+
+/*
+ * Hashes many independent keys at once
+ * - keys/lens: n inputs, like n calls to jenkins_hash_seeded
+ * - seed: shared by all keys
+ * - out: n results, out[i] matches jenkins_hash_seeded(keys[i], lens[i], seed) bit for bit
+ */
+void jenkins_hash_batch_seeded(const void* const keys[], const size_t lens[], size_t n, uint64_t seed, uint32_t out[]) {
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    static const uint8_t zero_byte = 0;
+
+    // Sorted by length a block at a time, padded with empty keys so the
+    // last group of lanes is always full
+    const uint8_t* sorted_keys[HASH_BLOCK + HASH_LANES];
+    uint32_t sorted_lengths[HASH_BLOCK + HASH_LANES];
+    uint32_t* sorted_out[HASH_BLOCK + HASH_LANES];
+    uint32_t lengths[HASH_BLOCK];
+    uint32_t unused;
+
+    for (size_t start = 0; start < n; start += HASH_BLOCK) {
+        size_t block = n - start < HASH_BLOCK ? n - start : HASH_BLOCK;
+
+        // Lanes count lengths in 32 bits, huge keys take the one by one path
+        for (size_t i = 0; i < block; i++) {
+            if (lens[start + i] > INT32_MAX) {
+                out[start + i] = jenkins_hash_seeded(keys[start + i], lens[start + i], seed);
+            }
+        }
+
+        // Counting sort on length / 4, good enough to keep lanes busy
+        size_t bucket_start[HASH_LENGTH_BUCKETS + 1] = {0};
+        for (size_t i = 0; i < block; i++) {
+            lengths[i] = lens[start + i] > INT32_MAX ? 0 : (uint32_t)lens[start + i];
+            uint32_t bucket = lengths[i] / 4 < HASH_LENGTH_BUCKETS ? lengths[i] / 4 : HASH_LENGTH_BUCKETS - 1;
+            bucket_start[bucket + 1]++;
+        }
+        for (int b = 0; b < HASH_LENGTH_BUCKETS; b++) {
+            bucket_start[b + 1] += bucket_start[b];
+        }
+        for (size_t i = 0; i < block; i++) {
+            uint32_t bucket = lengths[i] / 4 < HASH_LENGTH_BUCKETS ? lengths[i] / 4 : HASH_LENGTH_BUCKETS - 1;
+            size_t slot = bucket_start[bucket]++;
+            bool huge = lens[start + i] > INT32_MAX;
+            sorted_keys[slot] = lengths[i] ? (const uint8_t*)keys[start + i] : &zero_byte;
+            sorted_lengths[slot] = lengths[i];
+            sorted_out[slot] = huge ? &unused : &out[start + i];
+        }
+        for (size_t i = block; i < block + HASH_LANES; i++) {
+            sorted_keys[i] = &zero_byte;
+            sorted_lengths[i] = 0;
+            sorted_out[i] = &unused;
+        }
+
+        for (size_t i = 0; i < block; i += HASH_LANES) {
+            jenkins_hash_lanes(&sorted_keys[i], &sorted_lengths[i], fold_seed(seed), &sorted_out[i]);
+        }
+    }
+#else
+    for (size_t i = 0; i < n; i++) {
+        out[i] = jenkins_hash_seeded(keys[i], lens[i], seed);
+    }
+#endif
+}
+
+// Unseeded batch, out[i] matches jenkins_hash(keys[i], lens[i])
+void jenkins_hash_batch(const void* const keys[], const size_t lens[], size_t n, uint32_t out[]) {
+    jenkins_hash_batch_seeded(keys, lens, n, 0, out);
+}
+
+static uint64_t read_word(const uint8_t* data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));   // Unaligned safe load
+    return word;
+}
+
+// Murmur3 64-bit finalizer, every input bit affects every output bit
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/*
+ * Word-at-a-time hash
+ * Parameters:
+ * - key/len: the input data
+ * - seed: mixed into the starting state, 0 gives the unseeded variant
+ * Returns: 32-bit hash value
+ * Eats 8 bytes per multiply instead of 1 byte per three dependent steps,
+ * so long keys hash several times faster than with jenkins_hash.
+ */
+uint32_t word64_hash(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* data = (const uint8_t*)key;
+    uint64_t hash = mix64(seed ^ ((uint64_t)len * 0x9e3779b97f4a7c15ULL));
+
+    // Phase 1: whole 8-byte words, the multiply of the word is off the
+    // dependency chain so only xor, rotate and one multiply are serial
+    while (len >= 8) {
+        hash ^= read_word(data) * 0x87c37b91114253d5ULL;
+        hash = (hash << 31 | hash >> 33) * 0x4cf5ad432745937fULL;
+        data += 8;
+        len -= 8;
+    }
+
+    // Phase 2: the 0-7 byte tail, zero padded
+    if (len > 0) {
+        uint8_t tail[8] = {0};
+        memcpy(tail, data, len);
+        hash ^= read_word(tail) * 0x87c37b91114253d5ULL;
+        hash = (hash << 31 | hash >> 33) * 0x4cf5ad432745937fULL;
+    }
+
+    // Phase 3: avalanche and fold the 64-bit state down to 32 bits
+    hash = mix64(hash);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Second hash of a key from its first one, used by the perfect hash tables:
+// the key's bucket picks the displacement, this turns it into the final slot.
+// CuckooItemDatabase gets its second bucket from it the same way.
+// Murmur3 32-bit finalizer, so nearby displacements give unrelated slots.
+uint32_t hash_displace(uint32_t hash, uint32_t displacement) {
+    uint32_t x = hash ^ (displacement * 0x9e3779b9u);
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint32_t jenkins_hash_unseeded(const void* key, size_t len, uint64_t seed) {
+    (void)seed;
+    return jenkins_hash(key, len);
+}
+
+static uint32_t word64_hash_unseeded(const void* key, size_t len, uint64_t seed) {
+    (void)seed;
+    return word64_hash(key, len, 0);
+}
+
+HashFunction get_hash_function(HashFunctionId id) {
+    switch (id) {
+        case HASH_JENKINS_OAAT:   return jenkins_hash_unseeded;
+        case HASH_WORD64:         return word64_hash_unseeded;
+        case HASH_WORD64_SEEDED:  return word64_hash;
+        case HASH_JENKINS_SEEDED:
+        default:                  return jenkins_hash_seeded;
+    }
+}
+
+const char* hash_function_name(HashFunctionId id) {
+    switch (id) {
+        case HASH_JENKINS_SEEDED: return "jenkins-seeded";
+        case HASH_JENKINS_OAAT:   return "jenkins-oaat";
+        case HASH_WORD64:         return "word64";
+        case HASH_WORD64_SEEDED:  return "word64-seeded";
+        default:                  return "unknown";
+    }
+}
+
+// Whether the seed changes the result, reseeding only helps those
+bool hash_function_is_seeded(HashFunctionId id) {
+    return id == HASH_JENKINS_SEEDED || id == HASH_WORD64_SEEDED;
+}
+
+// Fill `out` from the operating system's random source, false if it has none
+// or the call failed
+static bool os_random(void* out, size_t len) {
+#if defined(_WIN32)
+    return BCRYPT_SUCCESS(BCryptGenRandom(NULL, out, (ULONG)len, BCRYPT_USE_SYSTEM_PREFERRED_RNG));
+#elif defined(__linux__)
+    return getrandom(out, len, 0) == (long)len;
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    arc4random_buf(out, len);
+    return true;
+#else
+    (void)out;
+    (void)len;
+    return false;
+#endif
+}
+
+// The seed is what keeps players from picking names that collide, so it
+// comes from the OS random source: time and addresses can be guessed. They
+// are only mixed together when that source fails.
+uint64_t random_hash_seed(void) {
+    uint64_t seed;
+    if (os_random(&seed, sizeof(seed)) && seed != 0) return seed;
+
+    static uint64_t counter = 0;
+    seed = (uint64_t)time(NULL) ^ (uint64_t)clock() << 32;
+    seed ^= (uint64_t)(uintptr_t)&counter;
+    seed += ++counter * 0x9e3779b97f4a7c15ULL;
+    return mix64(seed) | 1;   // Never 0
+}
@@ -0,0 +1,44 @@
+#ifndef HASH_CORE_HASH_H
+#define HASH_CORE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    HASH_JENKINS_SEEDED,   // Jenkins one-at-a-time starting from a per table seed
+    HASH_JENKINS_OAAT,     // One byte per step, the original function
+    HASH_WORD64,           // 8 bytes per step with 64-bit multiply mixing
+    HASH_WORD64_SEEDED,    // HASH_WORD64 keyed with a per table seed
+    HASH_FUNCTION_COUNT
+} HashFunctionId;
+
+// Every selectable hash has this shape, functions without a seed ignore it
+typedef uint32_t (*HashFunction)(const void* key, size_t len, uint64_t seed);
+
+uint32_t jenkins_hash(const void* key, size_t len);
+uint32_t jenkins_hash_seeded(const void* key, size_t len, uint64_t seed);
+
+// jenkins_hash over input that arrives in pieces: init, update with each
+// chunk in order, final. The result matches the one-shot call on the whole
+// input, seeded or not, no matter where the chunks were split.
+typedef struct {
+    uint32_t hash;
+    uint64_t length;                 // Bytes fed in so far
+} JenkinsHashState;
+
+void jenkins_hash_init(JenkinsHashState* state, uint64_t seed);
+void jenkins_hash_update(JenkinsHashState* state, const void* chunk, size_t len);
+uint32_t jenkins_hash_final(const JenkinsHashState* state);
+
+void jenkins_hash_batch(const void* const keys[], const size_t lens[], size_t n, uint32_t out[]);
+void jenkins_hash_batch_seeded(const void* const keys[], const size_t lens[], size_t n, uint64_t seed, uint32_t out[]);
+uint32_t word64_hash(const void* key, size_t len, uint64_t seed);
+uint32_t hash_displace(uint32_t hash, uint32_t displacement);
+
+HashFunction get_hash_function(HashFunctionId id);
+const char* hash_function_name(HashFunctionId id);
+bool hash_function_is_seeded(HashFunctionId id);
+uint64_t random_hash_seed(void);
+
+#endif //HASH_CORE_HASH_H
@@ -0,0 +1,220 @@
+#ifndef HASH_CORE_HASH_TABLE_H
+#define HASH_CORE_HASH_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/*
+ * Open addressing hash table, generated for one key and value type:
+ *
+ *   #define NAME_HASH(key, seed) jenkins_hash_seeded(key, strlen(key), seed)
+ *   #define NAME_EQUALS(a, b) (strcmp(a, b) == 0)
+ *   DEFINE_HASH_TABLE(NameTable, const char*, int, NAME_HASH, NAME_EQUALS)
+ *
+ * gives the types NameTable and NameTableEntry and static inline functions
+ * NameTable_init, NameTable_find, NameTable_insert, NameTable_remove, ...
+ * HASH and EQUALS are pasted in as they are, so the compiler sees the real
+ * types and can inline both; nothing goes through void* or a callback.
+ *
+ * Layout: linear probing over a power of two number of slots. Entries keep
+ * the full hash, and a separate control byte per slot holds HASH_TABLE_EMPTY or
+ * the top 7 hash bits, so a probe skips most slots without touching the
+ * entry or calling EQUALS. Growing reuses the cached hashes. Removal shifts
+ * the rest of the chain back instead of leaving tombstones.
+ *
+ * Keys are stored as they are: for pointer keys the caller keeps what they
+ * point at alive for as long as the entry exists.
+ */
+#define HASH_TABLE_EMPTY 0x80        // High bit set = free slot, otherwise a 7 bit tag
+#define HASH_TABLE_MIN_CAPACITY 16
+#define HASH_TABLE_MAX_LOAD_EIGHTHS 7   // Grows before an insert would go past 7/8 full
+
+/*
+ * Linear probing arithmetic, also used by ItemDatabase in HashMap/Inventory.c.
+ * `mask` is the capacity minus one, the capacity being a power of two.
+ */
+
+// Slots from `home` forward to `index`, wrapping around the end
+static inline size_t hash_table_probe_distance(size_t home, size_t index, size_t mask) {
+    return (index - home) & mask;
+}
+
+// Backward shift: the entry at `index`, `distance` slots past its home, may
+// move up into the hole unless its home lies cyclically in (hole, index]
+static inline bool hash_table_can_fill_hole(size_t hole, size_t index, size_t distance, size_t mask) {
+    return distance >= hash_table_probe_distance(hole, index, mask);
+}
+
+#define DEFINE_HASH_TABLE(Name, Key, Value, HASH, EQUALS) \
+\
+typedef struct { \
+    uint32_t hash; \
+    Key key; \
+    Value value; \
+} Name##Entry; \
+\
+typedef struct { \
+    Name##Entry* entries; \
+    uint8_t* ctrl;             /* HASH_TABLE_EMPTY or the tag of the entry */ \
+    size_t capacity;           /* Power of two */ \
+    size_t count; \
+    uint64_t seed;             /* Passed to HASH */ \
+} Name; \
+\
+static inline uint8_t Name##_tag(uint32_t hash) { \
+    return (uint8_t)(hash >> 25); \
+} \
+\
+static inline bool Name##_alloc(Name* table, size_t capacity) { \
+    table->entries = (Name##Entry*)malloc(capacity * sizeof(Name##Entry)); \
+    table->ctrl = (uint8_t*)malloc(capacity); \
+    if (!table->entries || !table->ctrl) { \
+        free(table->entries); \
+        free(table->ctrl); \
+        table->entries = NULL; \
+        table->ctrl = NULL; \
+        return false; \
+    } \
+    memset(table->ctrl, HASH_TABLE_EMPTY, capacity); \
+    table->capacity = capacity; \
+    table->count = 0; \
+    return true; \
+} \
+\
+/* Room for `capacity` slots, rounded up to a power of two */ \
+static inline bool Name##_init(Name* table, size_t capacity, uint64_t seed) { \
+    size_t slots = HASH_TABLE_MIN_CAPACITY; \
+    while (slots < capacity) slots <<= 1; \
+    table->seed = seed; \
+    return Name##_alloc(table, slots); \
+} \
+\
+static inline void Name##_free(Name* table) { \
+    free(table->entries); \
+    free(table->ctrl); \
+    table->entries = NULL; \
+    table->ctrl = NULL; \
+    table->capacity = 0; \
+    table->count = 0; \
+} \
+\
+static inline void Name##_clear(Name* table) { \
+    if (table->ctrl) memset(table->ctrl, HASH_TABLE_EMPTY, table->capacity); \
+    table->count = 0; \
+} \
+\
+static inline uint32_t Name##_hash(const Name* table, Key key) { \
+    return (uint32_t)(HASH(key, table->seed)); \
+} \
+\
+static inline size_t Name##_home(const Name* table, uint32_t hash) { \
+    return hash & (table->capacity - 1); \
+} \
+\
+/* Slots between the entry at `index` and its home */ \
+static inline size_t Name##_probe_distance(const Name* table, size_t index) { \
+    return hash_table_probe_distance(Name##_home(table, table->entries[index].hash), index, table->capacity - 1); \
+} \
+\
+/* For callers that hash keys themselves, in batches or with another seed */ \
+static inline Name##Entry* Name##_find_hashed(const Name* table, Key key, uint32_t hash) { \
+    if (!table->entries) return NULL; \
+    size_t mask = table->capacity - 1; \
+    size_t index = hash & mask; \
+    uint8_t tag = Name##_tag(hash); \
+    for (size_t probes = 0; probes < table->capacity; probes++) { \
+        uint8_t ctrl = table->ctrl[index]; \
+        if (ctrl == HASH_TABLE_EMPTY) break; \
+        Name##Entry* entry = &table->entries[index]; \
+        if (ctrl == tag && entry->hash == hash && (EQUALS(entry->key, key))) return entry; \
+        index = (index + 1) & mask; \
+    } \
+    return NULL; \
+} \
+\
+static inline Name##Entry* Name##_find(const Name* table, Key key) { \
+    return Name##_find_hashed(table, key, Name##_hash(table, key)); \
+} \
+\
+/* Place an entry known to be missing, there has to be a free slot */ \
+static inline Name##Entry* Name##_place(Name* table, Key key, Value value, uint32_t hash) { \
+    size_t mask = table->capacity - 1; \
+    size_t index = hash & mask; \
+    while (table->ctrl[index] != HASH_TABLE_EMPTY) index = (index + 1) & mask; \
+    Name##Entry* entry = &table->entries[index]; \
+    entry->hash = hash; \
+    entry->key = key; \
+    entry->value = value; \
+    table->ctrl[index] = Name##_tag(hash); \
+    table->count++; \
+    return entry; \
+} \
+\
+/* Move everything into `capacity` slots, the cached hashes make it a copy */ \
+static inline bool Name##_resize(Name* table, size_t capacity) { \
+    Name old = *table; \
+    size_t slots = HASH_TABLE_MIN_CAPACITY; \
+    while (slots < capacity || slots * HASH_TABLE_MAX_LOAD_EIGHTHS < old.count * 8) slots <<= 1; \
+    if (!Name##_alloc(table, slots)) { \
+        *table = old; \
+        return false; \
+    } \
+    for (size_t i = 0; i < old.capacity; i++) { \
+        if (old.ctrl[i] == HASH_TABLE_EMPTY) continue; \
+        const Name##Entry* entry = &old.entries[i]; \
+        Name##_place(table, entry->key, entry->value, entry->hash); \
+    } \
+    Name##_free(&old); \
+    return true; \
+} \
+\
+/* Returns the entry for `key`, the existing one if the key was there   \
+   already (its value is left alone) and NULL if growing failed.        \
+   `inserted` may be NULL. */ \
+static inline Name##Entry* Name##_insert_hashed(Name* table, Key key, Value value, uint32_t hash, bool* inserted) { \
+    Name##Entry* entry = Name##_find_hashed(table, key, hash); \
+    if (inserted) *inserted = entry == NULL; \
+    if (entry) return entry; \
+    if ((table->count + 1) * 8 > table->capacity * HASH_TABLE_MAX_LOAD_EIGHTHS \
+        && !Name##_resize(table, table->capacity * 2)) { \
+        if (inserted) *inserted = false; \
+        return NULL; \
+    } \
+    return Name##_place(table, key, value, hash); \
+} \
+\
+static inline Name##Entry* Name##_insert(Name* table, Key key, Value value, bool* inserted) { \
+    return Name##_insert_hashed(table, key, value, Name##_hash(table, key), inserted); \
+} \
+\
+/* Backward shift: later entries of the chain move up into the hole as   \
+   long as that does not put them before their home, so lookups never   \
+   stop early at a slot that used to hold something */ \
+static inline void Name##_remove_entry(Name* table, Name##Entry* entry) { \
+    size_t mask = table->capacity - 1; \
+    size_t hole = (size_t)(entry - table->entries); \
+    size_t index = (hole + 1) & mask; \
+    while (table->ctrl[index] != HASH_TABLE_EMPTY) { \
+        size_t home = Name##_home(table, table->entries[index].hash); \
+        if (hash_table_can_fill_hole(hole, index, hash_table_probe_distance(home, index, mask), mask)) { \
+            table->entries[hole] = table->entries[index]; \
+            table->ctrl[hole] = table->ctrl[index]; \
+            hole = index; \
+        } \
+        index = (index + 1) & mask; \
+    } \
+    table->ctrl[hole] = HASH_TABLE_EMPTY; \
+    table->count--; \
+} \
+\
+static inline bool Name##_remove(Name* table, Key key) { \
+    Name##Entry* entry = Name##_find(table, key); \
+    if (!entry) return false; \
+    Name##_remove_entry(table, entry); \
+    return true; \
+}
+
+#endif //HASH_CORE_HASH_TABLE_H
@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "Hash.h"
+
+/*
+ * Builds a minimal perfect hash over an item catalog and writes it out as C
+ * Usage: PerfectHashGen <items|names> <catalog file> <output .c file>
+ * - catalog file: one entry per line, # starts a comment
+ *   - items: "name,damage,durability", the output holds a GameItem per name
+ *     and implements find_catalog_item (HashMap's ItemCatalog.h)
+ *   - names: just the name, the output maps it to its line among the names
+ *     and implements find_catalog_index (Lab_0x11h's item_catalog.h)
+ * - output: a .c file that includes the header of the same name
+ *
+ * Hash and displace: every key gets h = jenkins_hash_seeded(key, seed).
+ * h picks one of about n/4 buckets, then the bucket's displacement d gives the
+ * slot hash_displace(h, d) % n. Buckets are placed biggest first, each one
+ * trying displacements until all of its keys land on free slots. With n keys
+ * in n slots, a lookup is one hash, one slot and one strcmp.
+ */
+
+#define MAX_LINE 256
+#define KEYS_PER_BUCKET 4
+#define MAX_DISPLACEMENT 1000000u    // Tries per bucket before picking another seed
+#define MAX_SEED_ATTEMPTS 64
+#define MAX_NAME 32                  // MAX_ITEM_NAME in HashMap and Lab_0x11h
+
+typedef enum {
+    CATALOG_ITEMS,
+    CATALOG_NAMES,
+} CatalogMode;
+
+typedef struct {
+    char name[MAX_NAME];
+    int damage;
+    int durability;
+} CatalogEntry;
+
+typedef struct {
+    CatalogMode mode;
+    CatalogEntry* items;
+    uint32_t* hashes;
+    size_t count;
+} Catalog;
+
+typedef struct {
+    uint64_t seed;
+    size_t bucket_count;
+    uint32_t* displacements;
+    size_t* slot_of;               // slot_of[i]: where catalog item i ends up
+} PerfectHash;
+
+static bool load_catalog(const char* path, CatalogMode mode, Catalog* catalog) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Could not open %s\n", path);
+        return false;
+    }
+
+    size_t capacity = 16;
+    *catalog = (Catalog){0};
+    catalog->mode = mode;
+    catalog->items = malloc(capacity * sizeof(CatalogEntry));
+
+    char line[MAX_LINE];
+    int line_number = 0;
+    bool ok = catalog->items != NULL;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        CatalogEntry item = {0};
+        char* name_end = line + strlen(line);
+        if (mode == CATALOG_ITEMS) {
+            name_end = strchr(line, ',');
+            if (!name_end || sscanf(name_end + 1, "%d,%d", &item.damage, &item.durability) != 2) {
+                printf("%s:%d: expected name,damage,durability\n", path, line_number);
+                ok = false;
+                break;
+            }
+        }
+        if (name_end == line || name_end - line >= MAX_NAME) {
+            printf("%s:%d: names are 1-%d bytes\n", path, line_number, MAX_NAME - 1);
+            ok = false;
+            break;
+        }
+        memcpy(item.name, line, (size_t)(name_end - line));
+
+        for (size_t i = 0; i < catalog->count; i++) {
+            if (strcmp(catalog->items[i].name, item.name) == 0) {
+                printf("%s:%d: duplicate item %s\n", path, line_number, item.name);
+                ok = false;
+            }
+        }
+
+        if (ok && catalog->count == capacity) {
+            capacity *= 2;
+            CatalogEntry* grown = realloc(catalog->items, capacity * sizeof(CatalogEntry));
+            if (!grown) ok = false;
+            else catalog->items = grown;
+        }
+        if (ok) catalog->items[catalog->count++] = item;
+    }
+
+    fclose(file);
+    if (ok && catalog->count == 0) {
+        printf("%s has no items\n", path);
+        ok = false;
+    }
+    if (ok) {
+        catalog->hashes = malloc(catalog->count * sizeof(uint32_t));
+        ok = catalog->hashes != NULL;
+    }
+    return ok;
+}
+
+// Order buckets by size, biggest first, they are the hardest to place
+static const size_t* sort_sizes;
+
+static int compare_bucket_size(const void* a, const void* b) {
+    size_t size_a = sort_sizes[*(const size_t*)a];
+    size_t size_b = sort_sizes[*(const size_t*)b];
+    if (size_a != size_b) return size_a > size_b ? -1 : 1;
+    return *(const size_t*)a < *(const size_t*)b ? -1 : 1;   // Keep the output deterministic
+}
+
+// Try to place every bucket under one seed
+static bool build_with_seed(const Catalog* catalog, PerfectHash* hash, size_t* bucket_sizes,
+                            size_t* order, size_t* members, bool* taken) {
+    size_t n = catalog->count;
+    size_t buckets = hash->bucket_count;
+
+    for (size_t i = 0; i < n; i++) {
+        const char* name = catalog->items[i].name;
+        catalog->hashes[i] = jenkins_hash_seeded(name, strlen(name), hash->seed);
+        // Equal hashes can never be split by a displacement
+        for (size_t j = 0; j < i; j++) {
+            if (catalog->hashes[j] == catalog->hashes[i]) return false;
+        }
+    }
+
+    memset(bucket_sizes, 0, buckets * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        bucket_sizes[catalog->hashes[i] % buckets]++;
+    }
+    for (size_t b = 0; b < buckets; b++) {
+        order[b] = b;
+    }
+    sort_sizes = bucket_sizes;
+    qsort(order, buckets, sizeof(size_t), compare_bucket_size);
+
+    memset(taken, 0, n * sizeof(bool));
+    memset(hash->displacements, 0, buckets * sizeof(uint32_t));
+
+    for (size_t k = 0; k < buckets && bucket_sizes[order[k]] > 0; k++) {
+        size_t bucket = order[k];
+        size_t size = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (catalog->hashes[i] % buckets == bucket) members[size++] = i;
+        }
+
+        bool placed = false;
+        for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; d++) {
+            placed = true;
+            for (size_t m = 0; m < size; m++) {
+                size_t slot = hash_displace(catalog->hashes[members[m]], d) % n;
+                if (taken[slot]) {
+                    placed = false;
+                    // Undo the members placed so far
+                    while (m-- > 0) taken[hash->slot_of[members[m]]] = false;
+                    break;
+                }
+                taken[slot] = true;
+                hash->slot_of[members[m]] = slot;
+            }
+            if (placed) hash->displacements[bucket] = d;
+        }
+        if (!placed) return false;
+    }
+
+    return true;
+}
+
+static bool build_perfect_hash(const Catalog* catalog, PerfectHash* hash) {
+    size_t n = catalog->count;
+    hash->bucket_count = (n + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+    hash->displacements = malloc(hash->bucket_count * sizeof(uint32_t));
+    hash->slot_of = malloc(n * sizeof(size_t));
+
+    size_t* bucket_sizes = malloc(hash->bucket_count * sizeof(size_t));
+    size_t* order = malloc(hash->bucket_count * sizeof(size_t));
+    size_t* members = malloc(n * sizeof(size_t));
+    bool* taken = malloc(n * sizeof(bool));
+
+    bool ok = false;
+    if (hash->displacements && hash->slot_of && bucket_sizes && order && members && taken) {
+        // Fixed seeds, so the same catalog always gives the same table
+        for (uint64_t attempt = 1; attempt <= MAX_SEED_ATTEMPTS && !ok; attempt++) {
+            hash->seed = attempt * 0x9e3779b97f4a7c15ULL;
+            ok = build_with_seed(catalog, hash, bucket_sizes, order, members, taken);
+        }
+    }
+
+    free(bucket_sizes);
+    free(order);
+    free(members);
+    free(taken);
+    return ok;
+}
+
+// Write a name as a C string literal, octal escapes keep it valid for any byte
+static void write_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(out, "\\%c", *c);
+        else if (*c < 0x20 || *c >= 0x7f) fprintf(out, "\\%03o", *c);
+        else fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+// File name without its directory
+static const char* base_name(const char* path) {
+    const char* name = path;
+    for (const char* c = path; *c; c++) {
+        if (*c == '/' || *c == '\\') name = c + 1;
+    }
+    return name;
+}
+
+// items: the GameItems themselves, in slot order
+static void write_items(FILE* out, const Catalog* catalog, const size_t* index_of_slot) {
+    fprintf(out, "static const GameItem catalog_items[CATALOG_SIZE] = {\n");
+    for (size_t s = 0; s < catalog->count; s++) {
+        const CatalogEntry* item = &catalog->items[index_of_slot[s]];
+        fprintf(out, "        {");
+        write_string(out, item->name);
+        fprintf(out, ", %d, %d},\n", item->damage, item->durability);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "const size_t catalog_item_count = CATALOG_SIZE;\n\n");
+    fprintf(out, "const GameItem* find_catalog_item(const char* name) {\n");
+    fprintf(out, "    if (!name) return NULL;\n\n");
+    fprintf(out, "    uint32_t hash = jenkins_hash_seeded(name, strlen(name), CATALOG_SEED);\n");
+    fprintf(out, "    uint32_t slot = hash_displace(hash, displacements[hash %% CATALOG_BUCKETS]) %% CATALOG_SIZE;\n");
+    fprintf(out, "    const GameItem* item = &catalog_items[slot];\n");
+    fprintf(out, "    return strcmp(item->name, name) == 0 ? item : NULL;\n");
+    fprintf(out, "}\n");
+}
+
+// names: each name with its line among the names, in slot order
+static void write_names(FILE* out, const Catalog* catalog, const size_t* index_of_slot) {
+    fprintf(out, "static const struct {\n");
+    fprintf(out, "    const char* name;\n");
+    fprintf(out, "    int index;\n");
+    fprintf(out, "} catalog_slots[CATALOG_SIZE] = {\n");
+    for (size_t s = 0; s < catalog->count; s++) {
+        fprintf(out, "        {");
+        write_string(out, catalog->items[index_of_slot[s]].name);
+        fprintf(out, ", %zu},\n", index_of_slot[s]);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "const int catalog_item_count = CATALOG_SIZE;\n\n");
+    fprintf(out, "int find_catalog_index(const char* name) {\n");
+    fprintf(out, "    if (!name) return -1;\n\n");
+    fprintf(out, "    uint32_t hash = jenkins_hash_seeded(name, strlen(name), CATALOG_SEED);\n");
+    fprintf(out, "    uint32_t slot = hash_displace(hash, displacements[hash %% CATALOG_BUCKETS]) %% CATALOG_SIZE;\n");
+    fprintf(out, "    return strcmp(catalog_slots[slot].name, name) == 0 ? catalog_slots[slot].index : -1;\n");
+    fprintf(out, "}\n");
+}
+
+static bool write_table(const char* path, const char* catalog_path, const Catalog* catalog, const PerfectHash* hash) {
+    // The header to implement: the output's name with .h, like ItemCatalog.c
+    const char* output_name = base_name(path);
+    size_t stem = strcspn(output_name, ".");
+    if (stem == 0) {
+        printf("Cannot name a header after %s\n", path);
+        return false;
+    }
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        printf("Could not write %s\n", path);
+        return false;
+    }
+
+    size_t n = catalog->count;
+    size_t* index_of_slot = malloc(n * sizeof(size_t));
+    if (!index_of_slot) {
+        fclose(out);
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        index_of_slot[hash->slot_of[i]] = i;
+    }
+
+    // Only file names, so the output does not depend on where the tree is
+    fprintf(out, "// Generated by PerfectHashGen from %s, do not edit\n", base_name(catalog_path));
+    fprintf(out, "#include <string.h>\n");
+    fprintf(out, "#include \"%.*s.h\"\n\n", (int)stem, output_name);
+    fprintf(out, "#define CATALOG_SIZE %zu\n", n);
+    fprintf(out, "#define CATALOG_BUCKETS %zu\n", hash->bucket_count);
+    fprintf(out, "#define CATALOG_SEED 0x%016llxULL\n\n", (unsigned long long)hash->seed);
+
+    fprintf(out, "static const uint32_t displacements[CATALOG_BUCKETS] = {\n");
+    for (size_t b = 0; b < hash->bucket_count; b++) {
+        fprintf(out, "        %uu,\n", (unsigned)hash->displacements[b]);
+    }
+    fprintf(out, "};\n\n");
+
+    if (catalog->mode == CATALOG_ITEMS) write_items(out, catalog, index_of_slot);
+    else write_names(out, catalog, index_of_slot);
+
+    free(index_of_slot);
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) ok = false;
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    CatalogMode mode = CATALOG_ITEMS;
+    if (argc >= 2 && strcmp(argv[1], "names") == 0) mode = CATALOG_NAMES;
+    if (argc < 4 || (mode == CATALOG_ITEMS && strcmp(argv[1], "items") != 0)) {
+        printf("Usage: %s <items|names> <catalog file> <output .c file>\n", argv[0]);
+        return 1;
+    }
+
+    Catalog catalog;
+    if (!load_catalog(argv[2], mode, &catalog)) return 1;
+
+    PerfectHash hash = {0};
+    bool ok = build_perfect_hash(&catalog, &hash);
+    if (!ok) {
+        printf("No perfect hash found for %zu items after %d seeds\n", catalog.count, MAX_SEED_ATTEMPTS);
+    } else {
+        ok = write_table(argv[3], argv[2], &catalog, &hash);
+    }
+
+    free(hash.displacements);
+    free(hash.slot_of);
+    free(catalog.items);
+    free(catalog.hashes);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "BenchmarkLab.h"
+// By path, so a case-insensitive file system does not pick our Inventory.h
+#include "../Lab_0x11h/inventory.h"
+
+struct LabInventory {
+    InventoryDatabase db;
+};
+
+LabInventory* create_lab_inventory(size_t slots) {
+    LabInventory* inventory = malloc(sizeof(LabInventory));
+    if (!inventory) return NULL;
+
+    init_inventory_database(&inventory->db);
+    // Presize like the other tables, it would grow from TABLE_SIZE otherwise
+    if (!inventory->db.table.entries || !NodeTable_resize(&inventory->db.table, slots)) {
+        free_inventory_database(&inventory->db);
+        free(inventory);
+        return NULL;
+    }
+    return inventory;
+}
+
+void destroy_lab_inventory(LabInventory* inventory) {
+    if (!inventory) return;
+    free_inventory_database(&inventory->db);
+    free(inventory);
+}
+
+bool lab_inventory_add(LabInventory* inventory, const char* name) {
+    Item item = {0};
+    strncpy(item.name, name, MAX_ITEM_NAME - 1);
+    item.value = 1;
+    item.weight = 1.0f;
+    return add_item_to_inventory(&inventory->db, &item, 1);
+}
+
+bool lab_inventory_find(LabInventory* inventory, const char* name) {
+    return find_item(&inventory->db, name) != NULL;
+}
+
+bool lab_inventory_remove(LabInventory* inventory, const char* name) {
+    return remove_item_from_inventory(&inventory->db, name, 1);
+}
+
+double lab_inventory_load_factor(const LabInventory* inventory) {
+    const NodeTable* table = &inventory->db.table;
+    return table->capacity ? (double)table->count / (double)table->capacity : 0.0;
+}
+
+size_t lab_inventory_slots(const LabInventory* inventory) {
+    return inventory->db.table.capacity;
+}
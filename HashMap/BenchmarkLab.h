@@ -0,0 +1,23 @@
+#ifndef HASHMAP_BENCHMARK_LAB_H
+#define HASHMAP_BENCHMARK_LAB_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Lab_0x11h's InventoryDatabase for BenchmarkSuite
+// Its inventory.h pulls in raylib and declares its own find_item and
+// find_items, so only BenchmarkLab.c includes it and the suite gets an opaque
+// handle. CMakeLists.txt renames those two for this target.
+typedef struct LabInventory LabInventory;
+
+// `slots`: the table is presized to at least this many, like the others
+LabInventory* create_lab_inventory(size_t slots);
+void destroy_lab_inventory(LabInventory* inventory);
+
+bool lab_inventory_add(LabInventory* inventory, const char* name);
+bool lab_inventory_find(LabInventory* inventory, const char* name);
+bool lab_inventory_remove(LabInventory* inventory, const char* name);
+double lab_inventory_load_factor(const LabInventory* inventory);
+size_t lab_inventory_slots(const LabInventory* inventory);
+
+#endif //HASHMAP_BENCHMARK_LAB_H
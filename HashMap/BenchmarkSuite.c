@@ -0,0 +1,779 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "Inventory.h"
+#include "CuckooInventory.h"
+#ifdef HASHMAP_BENCH_LAB
+#include "BenchmarkLab.h"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define HAVE_TSC 1
+#endif
+
+/*
+ * Benchmark suite for the table variants, to compare them and to catch regressions
+ * Usage: BenchmarkSuite [options]
+ *   --keys N[,N...]        Stored keys per run (default 100000)
+ *   --lengths SPEC         Key lengths: fixed:N, uniform:MIN-MAX or bimodal
+ *                          (most 4-12, every tenth 20-31), default uniform:8-24
+ *   --hit-ratio R[,R...]   Share of lookups for stored keys (default 0.9)
+ *   --load L[,L...]        How full the table is once every key is in, up to
+ *                          0.95 (default 0.5,0.75,0.9)
+ *   --ops N                Lookups per run (default 1000000)
+ *   --tables LIST          linear,robin-hood,cuckoo,lab (default all that are built)
+ *   --json                 One JSON object per line instead of a table
+ *
+ * Every combination runs for every table: add all keys, look up a random
+ * hit/miss mix, and for the Lab inventory remove all keys again. The
+ * ItemDatabase variants also load all keys with build_item_database. Tables are
+ * presized to the smallest power of two that holds the key count at the
+ * load factor, and the key count is then rounded up to fill it exactly.
+ * A table may still grow on its own, Robin Hood does when a chain gets too
+ * long: an incremental resize is finished before the lookups, and every row
+ * whose table grew while it was timed says so in the Grew column, its times
+ * include rehashing and its final load is lower than asked for.
+ *
+ * Every operation is timed on its own, which gives the percentiles; ns/op is
+ * the mean of those with the timer's own cost taken out. Cache misses per op
+ * are an estimate: the same run on a table small enough to stay in cache is
+ * the baseline, and the extra time over it is divided by the memory latency
+ * measured at start up with a pointer chase.
+ */
+
+#define DEFAULT_KEYS 100000
+#define DEFAULT_OPS 1000000
+#define DEFAULT_HIT_RATIO 0.9
+#define MAX_LIST 16                  // Values per comma separated option
+#define HOT_KEYS 512                 // Cache resident baseline for the miss estimate
+#define HOT_OPS 200000
+#define CHASE_BYTES (64u << 20)      // Well past any last level cache
+#define CHASE_STEPS 2000000
+#define CACHE_LINE 64
+
+static const double default_loads[] = {0.5, 0.75, 0.9};
+static const char key_alphabet[] = "abcdefghijklmnopqrstuvwxyz012345";   // 32 symbols, 5 bits each
+
+typedef enum {
+    TABLE_LINEAR,
+    TABLE_ROBIN_HOOD,
+    TABLE_CUCKOO,
+    TABLE_LAB,
+    TABLE_KIND_COUNT
+} TableKind;
+
+static const char* const table_names[TABLE_KIND_COUNT] = {"linear", "robin-hood", "cuckoo", "lab"};
+
+typedef enum {
+    LENGTHS_FIXED,
+    LENGTHS_UNIFORM,
+    LENGTHS_BIMODAL,
+} LengthKind;
+
+typedef struct {
+    LengthKind kind;
+    int min;
+    int max;
+    char text[32];             // As given, for the output
+} LengthSpec;
+
+typedef struct {
+    size_t keys;               // Rounded up, see above
+    size_t slots;
+    double load;
+    double hit_ratio;
+    size_t ops;
+    LengthSpec lengths;
+} RunConfig;
+
+typedef struct {
+    char (*stored)[MAX_ITEM_NAME];
+    char (*missing)[MAX_ITEM_NAME];
+    const char** lookups;      // ops names, each from stored or missing
+    bool* expect_hit;
+} KeySet;
+
+typedef enum {
+    OP_ADD,
+    OP_BUILD,
+    OP_FIND,
+    OP_REMOVE,
+    OP_KIND_COUNT
+} OpKind;
+
+static const char* const op_names[OP_KIND_COUNT] = {"add", "build", "find", "remove"};
+
+typedef struct {
+    bool ran;
+    bool bulk;                 // One call for all items, only ns_per_op means anything
+    bool grew;                 // The table grew while this op was timed
+    size_t count;
+    size_t errors;             // Adds or removes that failed, lookups with the wrong answer
+    double ns_per_op;
+    double p50, p90, p99, p999, max;
+    double cache_misses;       // Per op, estimated, negative when there is no baseline
+} OpResult;
+
+typedef struct {
+    TableKind kind;
+    ItemDatabase items;
+    CuckooItemDatabase cuckoo;
+#ifdef HASHMAP_BENCH_LAB
+    LabInventory* lab;
+#endif
+} Table;
+
+typedef struct {
+    double ticks_per_ns;
+    uint64_t overhead;         // Ticks two back to back reads take
+    double memory_latency_ns;
+} Machine;
+
+// ---- Timing ----
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// The time stamp counter where there is one, it costs far less than a clock call
+static uint64_t read_ticks(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+static int compare_ticks(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void calibrate_timer(Machine* machine) {
+    uint64_t start_ns = now_ns();
+    uint64_t start = read_ticks();
+    while (now_ns() - start_ns < 50000000u) {}
+    machine->ticks_per_ns = (double)(read_ticks() - start) / (double)(now_ns() - start_ns);
+
+    uint64_t samples[1001];
+    for (int i = 0; i < 1001; i++) {
+        uint64_t t0 = read_ticks();
+        samples[i] = read_ticks() - t0;
+    }
+    qsort(samples, 1001, sizeof(uint64_t), compare_ticks);
+    machine->overhead = samples[500];
+}
+
+// Random walk over CHASE_BYTES, one cache line per step and every load
+// depends on the one before, so each step is a full miss
+static double measure_memory_latency(void) {
+    size_t lines = CHASE_BYTES / CACHE_LINE;
+    size_t stride = CACHE_LINE / sizeof(size_t);
+    size_t* memory = malloc(CHASE_BYTES);
+    size_t* order = malloc(lines * sizeof(size_t));
+    if (!memory || !order) {
+        free(memory);
+        free(order);
+        return 0.0;
+    }
+
+    // Sattolo's shuffle gives one cycle through every line
+    uint64_t state = 0x9e3779b97f4a7c15u;
+    for (size_t i = 0; i < lines; i++) order[i] = i;
+    for (size_t i = lines - 1; i > 0; i--) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        size_t j = (size_t)((state >> 33) % i);
+        size_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (size_t i = 0; i < lines; i++) {
+        memory[order[i] * stride] = order[(i + 1) % lines] * stride;
+    }
+
+    size_t position = 0;
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < CHASE_STEPS; i++) position = memory[position];
+    uint64_t elapsed = now_ns() - start;
+
+    // Keeps the chase from being optimized away
+    volatile size_t sink = position;
+    (void)sink;
+    free(memory);
+    free(order);
+    return (double)elapsed / CHASE_STEPS;
+}
+
+// ---- Keys ----
+
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int pick_length(const LengthSpec* spec, uint32_t* state) {
+    switch (spec->kind) {
+        case LENGTHS_FIXED:
+            return spec->min;
+        case LENGTHS_UNIFORM:
+            return spec->min + (int)(next_random(state) % (uint32_t)(spec->max - spec->min + 1));
+        case LENGTHS_BIMODAL:
+            if (next_random(state) % 10 == 0) return 20 + (int)(next_random(state) % 12);
+            return 4 + (int)(next_random(state) % 9);
+    }
+    return spec->min;
+}
+
+// Keys start with their index in a fixed width, so they are all different
+// whatever random characters fill them up to their length
+static void make_key(char* key, size_t index, int width, int length, uint32_t* state) {
+    if (length < width) length = width;
+    if (length > MAX_ITEM_NAME - 1) length = MAX_ITEM_NAME - 1;
+    for (int i = width - 1; i >= 0; i--) {
+        key[i] = key_alphabet[index & 31];
+        index >>= 5;
+    }
+    for (int i = width; i < length; i++) {
+        key[i] = key_alphabet[next_random(state) & 31];
+    }
+    key[length] = '\0';
+}
+
+static void free_key_set(KeySet* set) {
+    free(set->stored);
+    free(set->missing);
+    free(set->lookups);
+    free(set->expect_hit);
+    *set = (KeySet){0};
+}
+
+static bool make_key_set(KeySet* set, const RunConfig* config, uint32_t seed) {
+    set->stored = malloc(config->keys * sizeof(*set->stored));
+    set->missing = malloc(config->keys * sizeof(*set->missing));
+    set->lookups = malloc(config->ops * sizeof(const char*));
+    set->expect_hit = malloc(config->ops * sizeof(bool));
+    if (!set->stored || !set->missing || !set->lookups || !set->expect_hit) {
+        free_key_set(set);
+        return false;
+    }
+
+    // Stored keys take indexes [0, keys), missing ones [keys, 2 * keys)
+    int width = 1;
+    while (width < 6 && ((size_t)1 << (5 * width)) < config->keys * 2) width++;
+
+    uint32_t state = seed | 1;
+    for (size_t i = 0; i < config->keys; i++) {
+        make_key(set->stored[i], i, width, pick_length(&config->lengths, &state), &state);
+        make_key(set->missing[i], config->keys + i, width, pick_length(&config->lengths, &state), &state);
+    }
+
+    uint32_t threshold = (uint32_t)(config->hit_ratio * 4294967295.0);
+    for (size_t i = 0; i < config->ops; i++) {
+        bool hit = next_random(&state) <= threshold && config->hit_ratio > 0.0;
+        size_t index = next_random(&state) % config->keys;
+        set->lookups[i] = hit ? set->stored[index] : set->missing[index];
+        set->expect_hit[i] = hit;
+    }
+    return true;
+}
+
+// ---- Tables ----
+
+// 0.95 is the highest load ItemDatabase takes, so it only grows when the keys
+// are past the asked for load or a Robin Hood chain gets too long
+static ItemDatabaseOptions table_options(TableKind kind, size_t slots) {
+    return (ItemDatabaseOptions){
+            .initial_capacity = slots,
+            .max_load_factor = 0.95f,
+            .probe_mode = kind == TABLE_ROBIN_HOOD ? PROBE_ROBIN_HOOD : PROBE_LINEAR,
+            .hash_function = HASH_JENKINS_SEEDED,
+    };
+}
+
+static bool table_create(Table* table, TableKind kind, size_t slots) {
+    *table = (Table){.kind = kind};
+    ItemDatabaseOptions options = table_options(kind, slots);
+
+    switch (kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            return init_item_database_with(&table->items, &options);
+        case TABLE_CUCKOO:
+            options.max_load_factor = 0.98f;
+            return init_cuckoo_item_database(&table->cuckoo, &options);
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            table->lab = create_lab_inventory(slots);
+            return table->lab != NULL;
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+    return false;
+}
+
+static void table_destroy(Table* table) {
+    switch (table->kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            free_item_database(&table->items);
+            break;
+        case TABLE_CUCKOO:
+            free_cuckoo_item_database(&table->cuckoo);
+            break;
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            destroy_lab_inventory(table->lab);
+            break;
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+}
+
+static bool table_add(Table* table, const char* name) {
+    switch (table->kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            return add_item(&table->items, name, 1, 1);
+        case TABLE_CUCKOO:
+            return cuckoo_add_item(&table->cuckoo, name, 1, 1);
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            return lab_inventory_add(table->lab, name);
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+    return false;
+}
+
+static bool table_find(Table* table, const char* name) {
+    switch (table->kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            return find_item(&table->items, name) != NULL;
+        case TABLE_CUCKOO:
+            return cuckoo_find_item(&table->cuckoo, name) != NULL;
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            return lab_inventory_find(table->lab, name);
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+    return false;
+}
+
+// build_item_database is ItemDatabase's own
+static bool table_can_build(TableKind kind) {
+    return kind == TABLE_LINEAR || kind == TABLE_ROBIN_HOOD;
+}
+
+// Only the Lab inventory can take items out
+static bool table_can_remove(TableKind kind) {
+    return kind == TABLE_LAB;
+}
+
+static bool table_remove(Table* table, const char* name) {
+#ifdef HASHMAP_BENCH_LAB
+    if (table->kind == TABLE_LAB) return lab_inventory_remove(table->lab, name);
+#endif
+    (void)table;
+    (void)name;
+    return false;
+}
+
+// Slots of the table, to tell whether it grew
+static size_t table_slots(const Table* table) {
+    switch (table->kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            return table->items.table.capacity;
+        case TABLE_CUCKOO:
+            return table->cuckoo.bucket_count * CUCKOO_BUCKET_SLOTS;
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            return lab_inventory_slots(table->lab);
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+    return 0;
+}
+
+// Finish an incremental resize, so lookups are timed on one table
+static void table_settle(Table* table) {
+    if (table->kind == TABLE_LINEAR || table->kind == TABLE_ROBIN_HOOD) {
+        finish_item_database_resize(&table->items);
+    }
+}
+
+static double table_load(const Table* table) {
+    switch (table->kind) {
+        case TABLE_LINEAR:
+        case TABLE_ROBIN_HOOD:
+            // item_database_count, the table's own count misses items still in old_table
+            return table->items.table.capacity
+                   ? (double)item_database_count(&table->items) / (double)table->items.table.capacity : 0.0;
+        case TABLE_CUCKOO:
+            return cuckoo_item_database_load_factor(&table->cuckoo);
+        case TABLE_LAB:
+#ifdef HASHMAP_BENCH_LAB
+            return lab_inventory_load_factor(table->lab);
+#endif
+        case TABLE_KIND_COUNT:
+            break;
+    }
+    return 0.0;
+}
+
+static bool table_available(TableKind kind) {
+#ifdef HASHMAP_BENCH_LAB
+    (void)kind;
+    return true;
+#else
+    return kind != TABLE_LAB;
+#endif
+}
+
+// ---- Runs ----
+
+static double ticks_to_ns(const Machine* machine, uint64_t ticks) {
+    return (double)ticks / machine->ticks_per_ns;
+}
+
+static void summarize(const Machine* machine, uint64_t samples[], size_t count, size_t errors, OpResult* result) {
+    *result = (OpResult){.ran = true, .count = count, .errors = errors, .cache_misses = -1.0};
+    if (count == 0) return;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = samples[i] > machine->overhead ? samples[i] - machine->overhead : 0;
+        total += samples[i];
+    }
+    qsort(samples, count, sizeof(uint64_t), compare_ticks);
+
+    result->ns_per_op = ticks_to_ns(machine, total) / (double)count;
+    result->p50 = ticks_to_ns(machine, samples[count / 2]);
+    result->p90 = ticks_to_ns(machine, samples[(size_t)((double)count * 0.90)]);
+    result->p99 = ticks_to_ns(machine, samples[(size_t)((double)count * 0.99)]);
+    result->p999 = ticks_to_ns(machine, samples[(size_t)((double)count * 0.999)]);
+    result->max = ticks_to_ns(machine, samples[count - 1]);
+}
+
+// One table through add, find and remove, `results` gets one entry per op
+static bool run_table(TableKind kind, const RunConfig* config, const KeySet* keys, const Machine* machine,
+                      uint64_t samples[], OpResult results[OP_KIND_COUNT], double* final_load) {
+    Table table;
+    if (!table_create(&table, kind, config->slots)) return false;
+    for (int op = 0; op < OP_KIND_COUNT; op++) results[op] = (OpResult){.cache_misses = -1.0};
+
+    size_t errors = 0;
+    size_t slots = table_slots(&table);
+    for (size_t i = 0; i < config->keys; i++) {
+        uint64_t start = read_ticks();
+        bool added = table_add(&table, keys->stored[i]);
+        samples[i] = read_ticks() - start;
+        if (!added) errors++;
+    }
+    summarize(machine, samples, config->keys, errors, &results[OP_ADD]);
+    table_settle(&table);
+    results[OP_ADD].grew = table_slots(&table) != slots;
+    *final_load = table_load(&table);
+
+    errors = 0;
+    slots = table_slots(&table);
+    for (size_t i = 0; i < config->ops; i++) {
+        uint64_t start = read_ticks();
+        bool found = table_find(&table, keys->lookups[i]);
+        samples[i] = read_ticks() - start;
+        if (found != keys->expect_hit[i]) errors++;
+    }
+    summarize(machine, samples, config->ops, errors, &results[OP_FIND]);
+    results[OP_FIND].grew = table_slots(&table) != slots;
+
+    if (table_can_build(kind)) {
+        GameItem* items = calloc(config->keys, sizeof(GameItem));
+        if (items) {
+            for (size_t i = 0; i < config->keys; i++) memcpy(items[i].name, keys->stored[i], MAX_ITEM_NAME);
+            ItemDatabaseOptions options = table_options(kind, config->slots);
+            ItemDatabase built;
+
+            uint64_t start = read_ticks();
+            bool ok = build_item_database(&built, items, config->keys, &options);
+            uint64_t ticks = read_ticks() - start;
+
+            results[OP_BUILD] = (OpResult){.ran = true, .bulk = true, .count = config->keys, .cache_misses = -1.0};
+            results[OP_BUILD].errors = ok ? config->keys - item_database_count(&built) : config->keys;
+            results[OP_BUILD].ns_per_op = ticks_to_ns(machine, ticks) / (double)config->keys;
+            results[OP_BUILD].grew = ok && built.table.capacity != config->slots;
+            if (ok) free_item_database(&built);
+            free(items);
+        }
+    }
+
+    if (table_can_remove(kind)) {
+        errors = 0;
+        slots = table_slots(&table);
+        for (size_t i = 0; i < config->keys; i++) {
+            uint64_t start = read_ticks();
+            bool removed = table_remove(&table, keys->stored[i]);
+            samples[i] = read_ticks() - start;
+            if (!removed) errors++;
+        }
+        summarize(machine, samples, config->keys, errors, &results[OP_REMOVE]);
+        results[OP_REMOVE].grew = table_slots(&table) != slots;
+    }
+
+    table_destroy(&table);
+    return true;
+}
+
+static RunConfig make_config(size_t keys, double load, double hit_ratio, size_t ops, const LengthSpec* lengths) {
+    RunConfig config = {.load = load, .hit_ratio = hit_ratio, .ops = ops, .lengths = *lengths};
+    config.slots = GROUP_WIDTH;
+    while ((double)config.slots * load < (double)keys) config.slots <<= 1;
+    config.keys = (size_t)((double)config.slots * load);
+    if (config.keys == 0) config.keys = 1;
+    return config;
+}
+
+static void print_text(const char* table, const RunConfig* config, double final_load,
+                       const OpResult results[OP_KIND_COUNT]) {
+    for (int op = 0; op < OP_KIND_COUNT; op++) {
+        const OpResult* r = &results[op];
+        if (!r->ran) continue;
+        printf("| %-10s | %-6s | %8zu | %-12s | %4.2f %4.2f | %4.2f | %7.1f | ",
+               table, op_names[op], config->keys, config->lengths.text, config->load, final_load, config->hit_ratio,
+               r->ns_per_op);
+        if (r->bulk) {
+            printf("%7s %7s %7s %8s %9s | ", "-", "-", "-", "-", "-");
+        } else {
+            printf("%7.1f %7.1f %7.1f %8.1f %9.1f | ", r->p50, r->p90, r->p99, r->p999, r->max);
+        }
+        printf("%5.2f | %6zu | %-4s |\n", r->cache_misses < 0 ? 0.0 : r->cache_misses, r->errors, r->grew ? "yes" : "no");
+    }
+}
+
+static void print_json(const char* table, const RunConfig* config, double final_load,
+                       const OpResult results[OP_KIND_COUNT]) {
+    for (int op = 0; op < OP_KIND_COUNT; op++) {
+        const OpResult* r = &results[op];
+        if (!r->ran) continue;
+        printf("{\"table\":\"%s\",\"op\":\"%s\",\"keys\":%zu,\"slots\":%zu,\"key_lengths\":\"%s\","
+               "\"load\":%.4f,\"final_load\":%.4f,\"hit_ratio\":%.4f,\"count\":%zu,\"errors\":%zu,"
+               "\"grew\":%s,\"ns_per_op\":%.2f,",
+               table, op_names[op], config->keys, config->slots, config->lengths.text,
+               config->load, final_load, config->hit_ratio, r->count, r->errors, r->grew ? "true" : "false",
+               r->ns_per_op);
+        if (r->bulk) {
+            printf("\"p50_ns\":null,\"p90_ns\":null,\"p99_ns\":null,\"p999_ns\":null,\"max_ns\":null,");
+        } else {
+            printf("\"p50_ns\":%.2f,\"p90_ns\":%.2f,\"p99_ns\":%.2f,\"p999_ns\":%.2f,\"max_ns\":%.2f,",
+                   r->p50, r->p90, r->p99, r->p999, r->max);
+        }
+        if (r->cache_misses < 0) {
+            printf("\"cache_misses_per_op\":null}\n");
+        } else {
+            printf("\"cache_misses_per_op\":%.3f}\n", r->cache_misses);
+        }
+    }
+}
+
+// Run `kind` on the config and on a cache resident copy of it, then report
+static void bench(TableKind kind, const RunConfig* config, const Machine* machine, bool json) {
+    RunConfig hot = make_config(HOT_KEYS, config->load, config->hit_ratio,
+                                config->ops < HOT_OPS ? config->ops : HOT_OPS, &config->lengths);
+    size_t sample_count = config->keys > config->ops ? config->keys : config->ops;
+    uint64_t* samples = malloc(sample_count * sizeof(uint64_t));
+    KeySet keys = {0}, hot_keys = {0};
+    if (!samples || !make_key_set(&keys, config, 0x2545f491u) || !make_key_set(&hot_keys, &hot, 0x2545f491u)) {
+        fprintf(stderr, "Could not allocate the keys for %zu\n", config->keys);
+        free(samples);
+        free_key_set(&keys);
+        return;
+    }
+
+    OpResult results[OP_KIND_COUNT], hot_results[OP_KIND_COUNT];
+    double final_load = 0.0, hot_load = 0.0;
+    if (!run_table(kind, &hot, &hot_keys, machine, samples, hot_results, &hot_load)
+        || !run_table(kind, config, &keys, machine, samples, results, &final_load)) {
+        fprintf(stderr, "Could not create a %s table of %zu slots\n", table_names[kind], config->slots);
+    } else {
+        for (int op = 0; op < OP_KIND_COUNT; op++) {
+            if (!results[op].ran || !hot_results[op].ran || machine->memory_latency_ns <= 0.0) continue;
+            double extra = results[op].ns_per_op - hot_results[op].ns_per_op;
+            results[op].cache_misses = extra > 0.0 ? extra / machine->memory_latency_ns : 0.0;
+        }
+        if (json) {
+            print_json(table_names[kind], config, final_load, results);
+        } else {
+            print_text(table_names[kind], config, final_load, results);
+        }
+        fflush(stdout);
+    }
+
+    free(samples);
+    free_key_set(&keys);
+    free_key_set(&hot_keys);
+}
+
+// ---- Options ----
+
+static size_t parse_list(const char* text, double values[], size_t max) {
+    size_t count = 0;
+    while (*text && count < max) {
+        char* end;
+        double value = strtod(text, &end);
+        if (end == text) return 0;
+        values[count++] = value;
+        text = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return 0;
+    }
+    return count;
+}
+
+static bool parse_lengths(const char* text, LengthSpec* spec) {
+    *spec = (LengthSpec){0};
+    snprintf(spec->text, sizeof(spec->text), "%s", text);
+    if (strcmp(text, "bimodal") == 0) {
+        spec->kind = LENGTHS_BIMODAL;
+        spec->min = 4;
+        spec->max = 31;
+        return true;
+    }
+    if (sscanf(text, "fixed:%d", &spec->min) == 1) {
+        spec->kind = LENGTHS_FIXED;
+        spec->max = spec->min;
+    } else if (sscanf(text, "uniform:%d-%d", &spec->min, &spec->max) == 2) {
+        spec->kind = LENGTHS_UNIFORM;
+    } else {
+        return false;
+    }
+    return spec->min >= 1 && spec->min <= spec->max && spec->max <= MAX_ITEM_NAME - 1;
+}
+
+static bool parse_tables(const char* text, bool selected[TABLE_KIND_COUNT]) {
+    for (int i = 0; i < TABLE_KIND_COUNT; i++) selected[i] = false;
+    while (*text) {
+        size_t length = strcspn(text, ",");
+        int kind = 0;
+        while (kind < TABLE_KIND_COUNT
+               && (strlen(table_names[kind]) != length || strncmp(table_names[kind], text, length) != 0)) {
+            kind++;
+        }
+        if (kind == TABLE_KIND_COUNT) return false;
+        selected[kind] = true;
+        text += length + (text[length] == ',');
+    }
+    return true;
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s [--keys N,...] [--lengths fixed:N|uniform:MIN-MAX|bimodal] [--hit-ratio R,...]\n"
+           "       [--load L,...] [--ops N] [--tables linear,robin-hood,cuckoo,lab] [--json]\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    double key_counts[MAX_LIST] = {DEFAULT_KEYS};
+    size_t key_count_n = 1;
+    double hit_ratios[MAX_LIST] = {DEFAULT_HIT_RATIO};
+    size_t hit_ratio_n = 1;
+    double loads[MAX_LIST];
+    size_t load_n = sizeof(default_loads) / sizeof(default_loads[0]);
+    memcpy(loads, default_loads, sizeof(default_loads));
+    size_t ops = DEFAULT_OPS;
+    LengthSpec lengths;
+    parse_lengths("uniform:8-24", &lengths);
+    bool selected[TABLE_KIND_COUNT];
+    for (int i = 0; i < TABLE_KIND_COUNT; i++) selected[i] = table_available((TableKind)i);
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : "";
+        bool ok = true;
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+            continue;
+        } else if (strcmp(argv[i], "--keys") == 0) {
+            ok = (key_count_n = parse_list(value, key_counts, MAX_LIST)) > 0;
+        } else if (strcmp(argv[i], "--hit-ratio") == 0) {
+            ok = (hit_ratio_n = parse_list(value, hit_ratios, MAX_LIST)) > 0;
+        } else if (strcmp(argv[i], "--load") == 0) {
+            ok = (load_n = parse_list(value, loads, MAX_LIST)) > 0;
+        } else if (strcmp(argv[i], "--ops") == 0) {
+            ok = (ops = strtoul(value, NULL, 10)) > 0;
+        } else if (strcmp(argv[i], "--lengths") == 0) {
+            ok = parse_lengths(value, &lengths);
+        } else if (strcmp(argv[i], "--tables") == 0) {
+            ok = parse_tables(value, selected);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    for (size_t i = 0; i < load_n; i++) {
+        if (loads[i] <= 0.0 || loads[i] > 0.95) {
+            printf("Load factors go up to 0.95\n");
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < hit_ratio_n; i++) {
+        if (hit_ratios[i] < 0.0 || hit_ratios[i] > 1.0) {
+            printf("Hit ratios go from 0 to 1\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < TABLE_KIND_COUNT; i++) {
+        if (selected[i] && !table_available((TableKind)i)) {
+            fprintf(stderr, "%s is not built in, configure with raylib available\n", table_names[i]);
+            selected[i] = false;
+        }
+    }
+
+    Machine machine;
+    calibrate_timer(&machine);
+    machine.memory_latency_ns = measure_memory_latency();
+
+    if (json) {
+        printf("{\"memory_latency_ns\":%.2f,\"ticks_per_ns\":%.4f,\"timer_overhead_ns\":%.2f}\n",
+               machine.memory_latency_ns, machine.ticks_per_ns, ticks_to_ns(&machine, machine.overhead));
+    } else {
+        printf("Memory latency %.1f ns, timer overhead %.1f ns (taken out of every sample)\n",
+               machine.memory_latency_ns, ticks_to_ns(&machine, machine.overhead));
+        printf("Load: asked for and where the table ended; Miss/op: estimated cache misses\n\n");
+        printf("| Table      | Op     |     Keys | Key lengths  | Load      | Hit  |   ns/op |     p50     p90     p99    p99.9       max | Miss  | Errors | Grew |\n");
+    }
+
+    for (size_t k = 0; k < key_count_n; k++) {
+        for (size_t l = 0; l < load_n; l++) {
+            for (size_t h = 0; h < hit_ratio_n; h++) {
+                RunConfig config = make_config((size_t)key_counts[k], loads[l], hit_ratios[h], ops, &lengths);
+                for (int t = 0; t < TABLE_KIND_COUNT; t++) {
+                    if (selected[t]) bench((TableKind)t, &config, &machine, json);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "Inventory.h"
+#include "ConcurrentInventory.h"
+
+/*
+ * Read scaling of ConcurrentItemDatabase against ItemDatabase behind one mutex
+ * Usage: ConcurrencyBenchmark [items] [max threads]
+ * Every thread looks up random names from the same table, thread counts go
+ * 1, 2, 4, ... up to max threads. The mixed column lets every eighth
+ * operation add a name instead, new ones at first and existing ones later.
+ */
+
+#define DEFAULT_ITEMS 100000
+#define DEFAULT_MAX_THREADS 8
+#define OPS_PER_THREAD 2000000
+#define NAME_LENGTH 24
+#define NEW_NAMES_PER_THREAD 8192    // Mixed runs cycle through these, later adds find them present
+
+typedef enum {
+    RUN_LOCKED_READS,
+    RUN_CONCURRENT_READS,
+    RUN_CONCURRENT_MIXED,
+} RunKind;
+
+typedef struct {
+    RunKind kind;
+    ItemDatabase* locked_db;
+    pthread_mutex_t* lock;
+    ConcurrentItemDatabase* concurrent_db;
+    char (*names)[NAME_LENGTH];
+    size_t name_count;
+    unsigned thread_index;
+    size_t found;
+} Worker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// xorshift, each thread gets its own stream
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void* run_worker(void* arg) {
+    Worker* worker = arg;
+    uint32_t state = 0x9e3779b9u * (worker->thread_index + 1);
+    char fresh[NAME_LENGTH];
+    size_t found = 0;
+
+    for (size_t op = 0; op < OPS_PER_THREAD; op++) {
+        const char* name = worker->names[next_random(&state) % worker->name_count];
+
+        switch (worker->kind) {
+            case RUN_LOCKED_READS:
+                pthread_mutex_lock(worker->lock);
+                if (find_item(worker->locked_db, name)) found++;
+                pthread_mutex_unlock(worker->lock);
+                break;
+            case RUN_CONCURRENT_MIXED:
+                if ((op & 7) == 7) {
+                    snprintf(fresh, sizeof(fresh), "new-%u-%zu", worker->thread_index, op % NEW_NAMES_PER_THREAD);
+                    concurrent_add_item(worker->concurrent_db, fresh, 1, 1);
+                    break;
+                }
+                // fall through
+            case RUN_CONCURRENT_READS:
+                if (concurrent_find_item(worker->concurrent_db, name)) found++;
+                break;
+        }
+    }
+
+    worker->found = found;
+    return NULL;
+}
+
+// Millions of operations per second over all threads
+static double run(RunKind kind, unsigned threads, ItemDatabase* locked_db, pthread_mutex_t* lock,
+                  ConcurrentItemDatabase* concurrent_db, char (*names)[NAME_LENGTH], size_t name_count) {
+    pthread_t ids[64];
+    Worker workers[64];
+
+    double start = now_seconds();
+    for (unsigned t = 0; t < threads; t++) {
+        workers[t] = (Worker){kind, locked_db, lock, concurrent_db, names, name_count, t, 0};
+        pthread_create(&ids[t], NULL, run_worker, &workers[t]);
+    }
+    for (unsigned t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    return (double)OPS_PER_THREAD * threads / elapsed / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    size_t item_count = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ITEMS;
+    unsigned max_threads = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : DEFAULT_MAX_THREADS;
+    if (item_count == 0) item_count = DEFAULT_ITEMS;
+    if (max_threads == 0 || max_threads > 64) max_threads = DEFAULT_MAX_THREADS;
+
+    char (*names)[NAME_LENGTH] = malloc(item_count * NAME_LENGTH);
+    if (!names) return 1;
+    for (size_t i = 0; i < item_count; i++) {
+        snprintf(names[i], NAME_LENGTH, "item-%zu", i);
+    }
+
+    // Room for the names the mixed runs add
+    size_t added = (size_t)NEW_NAMES_PER_THREAD * max_threads;
+    ItemDatabaseOptions options = {.initial_capacity = (item_count + added) * 2};
+
+    ItemDatabase locked_db;
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    ConcurrentItemDatabase concurrent_db;
+    if (!init_item_database(&locked_db) || !init_concurrent_item_database(&concurrent_db, &options)) {
+        printf("Could not allocate the tables\n");
+        return 1;
+    }
+    for (size_t i = 0; i < item_count; i++) {
+        add_item(&locked_db, names[i], (int)i, 100);
+        concurrent_add_item(&concurrent_db, names[i], (int)i, 100);
+    }
+
+    printf("%zu items, %d lookups per thread, Mops/s over all threads\n\n", item_count, OPS_PER_THREAD);
+    printf("+---------+--------------+--------------+--------------+\n");
+    printf("| Threads | Mutex reads  | Lock-free    | Mixed 1:7    |\n");
+    printf("+---------+--------------+--------------+--------------+\n");
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        double locked = run(RUN_LOCKED_READS, threads, &locked_db, &lock, &concurrent_db, names, item_count);
+        double reads = run(RUN_CONCURRENT_READS, threads, &locked_db, &lock, &concurrent_db, names, item_count);
+        double mixed = run(RUN_CONCURRENT_MIXED, threads, &locked_db, &lock, &concurrent_db, names, item_count);
+        printf("| %7u | %12.1f | %12.1f | %12.1f |\n", threads, locked, reads, mixed);
+    }
+    printf("+---------+--------------+--------------+--------------+\n");
+
+    free_item_database(&locked_db);
+    free_concurrent_item_database(&concurrent_db);
+    pthread_mutex_destroy(&lock);
+    free(names);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "ConcurrentInventory.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPU_RELAX() _mm_pause()
+#else
+#define CPU_RELAX() ((void)0)
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#define YIELD_THREAD() SwitchToThread()
+#else
+#include <sched.h>
+#define YIELD_THREAD() sched_yield()
+#endif
+
+#define SPINS_BEFORE_YIELD 64        // The holder may have been preempted, stop burning its core
+
+/*
+ * How readers and writers stay out of each other's way:
+ * - A writer claims a slot by swapping its control byte from CTRL_EMPTY to
+ *   CTRL_BUSY, fills in the entry, then stores the tag with release order.
+ * - A reader loads control bytes with acquire order, so once it sees a tag
+ *   the entry behind it is complete. Entries are never changed afterwards,
+ *   which is what lets readers skip any version check or retry.
+ * - Two writers of the same name hash to the same stripe and run one after
+ *   the other, so a name is never added twice. Writers on different
+ *   stripes only meet on slots, where the swap decides who gets one.
+ */
+
+static uint8_t hash_tag(uint32_t hash) {
+    return (uint8_t)(hash >> 25);
+}
+
+static size_t stripe_of(const ConcurrentItemDatabase* db, uint32_t hash) {
+    // Neighbouring buckets share a stripe, the low bits already pick the bucket
+    return (hash & (db->capacity - 1)) * CONCURRENT_STRIPES / db->capacity;
+}
+
+static void lock_stripe(ConcurrentItemDatabase* db, size_t stripe) {
+    unsigned spins = 0;
+    while (atomic_flag_test_and_set_explicit(&db->stripes[stripe], memory_order_acquire)) {
+        if (++spins < SPINS_BEFORE_YIELD) {
+            CPU_RELAX();
+        } else {
+            YIELD_THREAD();
+            spins = 0;
+        }
+    }
+}
+
+static void unlock_stripe(ConcurrentItemDatabase* db, size_t stripe) {
+    atomic_flag_clear_explicit(&db->stripes[stripe], memory_order_release);
+}
+
+bool init_concurrent_item_database(ConcurrentItemDatabase* db, const ItemDatabaseOptions* options) {
+    if (!db || !options) return false;
+
+    size_t initial_capacity = options->initial_capacity ? options->initial_capacity : INITIAL_CAPACITY;
+    size_t capacity = CONCURRENT_STRIPES;
+    while (capacity < initial_capacity) capacity <<= 1;
+
+    float max_load_factor = options->max_load_factor;
+    if (max_load_factor <= 0.1f || max_load_factor > 0.95f) {
+        max_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    }
+
+    db->entries = malloc(capacity * sizeof(HashEntry));
+    db->ctrl = malloc(capacity * sizeof(_Atomic uint8_t));
+    if (!db->entries || !db->ctrl) {
+        free(db->entries);
+        free((void*)db->ctrl);
+        db->entries = NULL;
+        db->ctrl = NULL;
+        return false;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&db->ctrl[i], CTRL_EMPTY);
+    }
+    for (size_t i = 0; i < CONCURRENT_STRIPES; i++) {
+        atomic_flag_clear(&db->stripes[i]);
+    }
+
+    db->capacity = capacity;
+    db->max_count = (size_t)((float)capacity * max_load_factor);
+    atomic_init(&db->count, 0);
+    db->hash = get_hash_function(options->hash_function);
+    db->seed = options->seed;
+    if (hash_function_is_seeded(options->hash_function) && db->seed == 0) {
+        db->seed = random_hash_seed();
+    }
+
+    return true;
+}
+
+// Not thread safe, every other thread has to be done with the database
+void free_concurrent_item_database(ConcurrentItemDatabase* db) {
+    if (!db) return;
+    free(db->entries);
+    free((void*)db->ctrl);
+    db->entries = NULL;
+    db->ctrl = NULL;
+    db->capacity = 0;
+    atomic_store(&db->count, 0);
+}
+
+static const HashEntry* find_entry(const ConcurrentItemDatabase* db, const char* name, uint32_t hash) {
+    size_t mask = db->capacity - 1;
+    size_t index = hash & mask;
+    uint8_t tag = hash_tag(hash);
+
+    // At most one pass over the table, so a reader finishes in bounded steps
+    for (size_t probes = 0; probes < db->capacity; probes++) {
+        uint8_t ctrl = atomic_load_explicit(&db->ctrl[index], memory_order_acquire);
+        if (ctrl == CTRL_EMPTY) break;
+
+        // A busy slot is an add that has not finished yet, skip over it
+        const HashEntry* entry = &db->entries[index];
+        if (ctrl == tag && entry->hash == hash && strcmp(entry->item.name, name) == 0) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+bool concurrent_add_item(ConcurrentItemDatabase* db, const char* name, int damage, int durability) {
+    if (!db || !name || !db->entries) return false;
+
+    HashEntry entry = {0};
+    strncpy(entry.item.name, name, MAX_ITEM_NAME - 1);
+    entry.item.damage = damage;
+    entry.item.durability = durability;
+    entry.hash = db->hash(entry.item.name, strlen(entry.item.name), db->seed);
+
+    size_t stripe = stripe_of(db, entry.hash);
+    lock_stripe(db, stripe);
+
+    bool added = false;
+    if (!find_entry(db, entry.item.name, entry.hash)) {
+        // Reserve room first, so the table never fills up and the
+        // slot search below always ends at a free slot
+        size_t count = atomic_fetch_add_explicit(&db->count, 1, memory_order_relaxed);
+        if (count >= db->max_count) {
+            atomic_fetch_sub_explicit(&db->count, 1, memory_order_relaxed);
+        } else {
+            size_t mask = db->capacity - 1;
+            size_t home = entry.hash & mask;
+            size_t index = home;
+
+            for (;;) {
+                uint8_t expected = CTRL_EMPTY;
+                if (atomic_load_explicit(&db->ctrl[index], memory_order_relaxed) == CTRL_EMPTY
+                    && atomic_compare_exchange_strong_explicit(&db->ctrl[index], &expected, CTRL_BUSY,
+                                                               memory_order_acquire, memory_order_relaxed)) {
+                    break;
+                }
+                index = (index + 1) & mask;
+            }
+
+            entry.probe_distance = (uint32_t)((index - home) & mask);
+            db->entries[index] = entry;
+            atomic_store_explicit(&db->ctrl[index], hash_tag(entry.hash), memory_order_release);
+            added = true;
+        }
+    }
+
+    unlock_stripe(db, stripe);
+    return added;
+}
+
+const GameItem* concurrent_find_item(const ConcurrentItemDatabase* db, const char* name) {
+    if (!db || !name || !db->entries) return NULL;
+
+    uint32_t hash = db->hash(name, strlen(name), db->seed);
+    const HashEntry* entry = find_entry(db, name, hash);
+    return entry ? &entry->item : NULL;
+}
+
+size_t concurrent_item_database_count(const ConcurrentItemDatabase* db) {
+    return atomic_load_explicit(&((ConcurrentItemDatabase*)db)->count, memory_order_relaxed);
+}
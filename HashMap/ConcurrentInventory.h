@@ -0,0 +1,41 @@
+#ifndef HASHMAP_CONCURRENT_INVENTORY_H
+#define HASHMAP_CONCURRENT_INVENTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "Inventory.h"
+
+// ItemDatabase for many threads at once
+// - find: wait-free, a bounded number of atomic loads and no locks or retries
+// - add: locks only the stripe of the name's home bucket
+// Entries are written once and never moved, so the table is sized up front
+// (initial_capacity and max_load_factor from ItemDatabaseOptions) and
+// concurrent_add_item fails once it is full instead of growing.
+#define CONCURRENT_STRIPES 64        // Writer locks, power of two
+#define CTRL_BUSY 0xFE               // Slot claimed by a writer that is still filling it in
+
+typedef struct {
+    HashEntry* entries;
+    _Atomic uint8_t* ctrl;           // CTRL_EMPTY, CTRL_BUSY or the 7 bit tag
+    size_t capacity;                 // Power of two
+    size_t max_count;                // Adds fail past this
+    atomic_size_t count;
+    HashFunction hash;
+    uint64_t seed;
+    atomic_flag stripes[CONCURRENT_STRIPES];
+} ConcurrentItemDatabase;
+
+bool init_concurrent_item_database(ConcurrentItemDatabase* db, const ItemDatabaseOptions* options);
+void free_concurrent_item_database(ConcurrentItemDatabase* db);
+
+// False if the name is already there or the table is full
+bool concurrent_add_item(ConcurrentItemDatabase* db, const char* name, int damage, int durability);
+
+// The item stays valid and unchanged until the database is freed
+const GameItem* concurrent_find_item(const ConcurrentItemDatabase* db, const char* name);
+
+size_t concurrent_item_database_count(const ConcurrentItemDatabase* db);
+
+#endif //HASHMAP_CONCURRENT_INVENTORY_H
@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "CredentialBatch.h"
+
+/*
+ * A fixed pool of batches goes round in a ring:
+ *   reader: take a free batch, fill it with lines, queue it as full
+ *   worker: take a full batch, verify every line, hand it back as free
+ * The reader blocks once every batch is queued or being verified, so memory
+ * stays at the pool size however long the input is.
+ */
+
+#define BATCHES_PER_THREAD 2
+
+// Latency histogram: exact below 16 ns, above that 16 linear steps per
+// power of two, so every bucket is within about 6% of its values
+#define LATENCY_SUB_BUCKETS 16
+#define LATENCY_BUCKETS (LATENCY_SUB_BUCKETS * 60)
+
+typedef struct {
+    char lines[ATTEMPTS_PER_BATCH][MAX_ATTEMPT_LINE];
+    size_t count;
+} AttemptBatch;
+
+typedef struct {
+    size_t accepted;
+    size_t wrong_password;
+    size_t unknown_user;
+    size_t malformed;
+    uint64_t max_ns;
+    uint64_t latency[LATENCY_BUCKETS];
+} WorkerTotals;
+
+typedef struct {
+    const CredentialStore* store;
+    AttemptBatch** ring;       // Full batches waiting for a worker
+    size_t ring_size;
+    size_t head;
+    size_t queued;
+    bool done;                 // No more input, workers exit once the ring is empty
+    AttemptBatch** free_list;
+    size_t free_count;
+    pthread_mutex_t lock;
+    pthread_cond_t has_full;
+    pthread_cond_t has_free;
+} BatchQueue;
+
+typedef struct {
+    BatchQueue* queue;
+    WorkerTotals totals;
+} BatchWorker;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static size_t latency_bucket(uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) return (size_t)ns;
+
+    unsigned exponent = 0;
+    while ((ns >> exponent) >= 2 * LATENCY_SUB_BUCKETS) exponent++;
+    size_t bucket = (size_t)(exponent + 1) * LATENCY_SUB_BUCKETS + (size_t)((ns >> exponent) - LATENCY_SUB_BUCKETS);
+    return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+// Smallest value that lands in the bucket
+static uint64_t latency_bucket_floor(size_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) return bucket;
+
+    unsigned exponent = (unsigned)(bucket / LATENCY_SUB_BUCKETS) - 1;
+    return (uint64_t)(LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << exponent;
+}
+
+static void verify_batch(const CredentialStore* store, const AttemptBatch* batch, WorkerTotals* totals) {
+    for (size_t i = 0; i < batch->count; i++) {
+        const char* line = batch->lines[i];
+        size_t length = strlen(line);
+        const char* colon = memchr(line, ':', length);
+        if (!colon) {
+            totals->malformed++;
+            continue;
+        }
+
+        size_t username_length = (size_t)(colon - line);
+        uint64_t start = now_ns();
+        VerifyResult result = verify_user(store, line, username_length, colon + 1, length - username_length - 1);
+        uint64_t elapsed = now_ns() - start;
+
+        totals->latency[latency_bucket(elapsed)]++;
+        if (elapsed > totals->max_ns) totals->max_ns = elapsed;
+        switch (result) {
+            case VERIFY_OK:             totals->accepted++; break;
+            case VERIFY_WRONG_PASSWORD: totals->wrong_password++; break;
+            case VERIFY_UNKNOWN_USER:   totals->unknown_user++; break;
+        }
+    }
+}
+
+static void* run_batch_worker(void* arg) {
+    BatchWorker* worker = arg;
+    BatchQueue* queue = worker->queue;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->queued == 0 && !queue->done) pthread_cond_wait(&queue->has_full, &queue->lock);
+        if (queue->queued == 0) {
+            pthread_mutex_unlock(&queue->lock);
+            return NULL;
+        }
+        AttemptBatch* batch = queue->ring[queue->head];
+        queue->head = (queue->head + 1) % queue->ring_size;
+        queue->queued--;
+        pthread_mutex_unlock(&queue->lock);
+
+        verify_batch(queue->store, batch, &worker->totals);
+
+        pthread_mutex_lock(&queue->lock);
+        queue->free_list[queue->free_count++] = batch;
+        pthread_cond_signal(&queue->has_free);
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+// Reads up to ATTEMPTS_PER_BATCH lines, blank ones are skipped and
+// over-long ones are skipped and counted as malformed
+static void fill_batch(AttemptBatch* batch, FILE* attempts, size_t* malformed) {
+    batch->count = 0;
+    while (batch->count < ATTEMPTS_PER_BATCH) {
+        char* line = batch->lines[batch->count];
+        if (!fgets(line, MAX_ATTEMPT_LINE, attempts)) break;
+
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] != '\n' && !feof(attempts)) {
+            int c;
+            while ((c = fgetc(attempts)) != EOF && c != '\n') {}
+            (*malformed)++;
+            continue;
+        }
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+        if (length == 0) continue;
+        batch->count++;
+    }
+}
+
+static double latency_percentile(const uint64_t histogram[], size_t total, double fraction) {
+    if (total == 0) return 0.0;
+
+    size_t rank = (size_t)(fraction * (double)(total - 1));
+    size_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen > rank) return (double)latency_bucket_floor(i);
+    }
+    return (double)latency_bucket_floor(LATENCY_BUCKETS - 1);
+}
+
+bool verify_attempts(const CredentialStore* store, FILE* attempts, unsigned threads, BatchReport* report) {
+    if (!store || !attempts || !report) return false;
+    if (threads == 0) threads = 1;
+    if (threads > MAX_BATCH_THREADS) threads = MAX_BATCH_THREADS;
+
+    size_t pool_size = (size_t)threads * BATCHES_PER_THREAD;
+    AttemptBatch* pool = malloc(pool_size * sizeof(AttemptBatch));
+    AttemptBatch** ring = malloc(pool_size * sizeof(AttemptBatch*));
+    AttemptBatch** free_list = malloc(pool_size * sizeof(AttemptBatch*));
+    BatchWorker* workers = calloc(threads, sizeof(BatchWorker));
+    pthread_t* ids = malloc(threads * sizeof(pthread_t));
+    if (!pool || !ring || !free_list || !workers || !ids) {
+        free(pool);
+        free(ring);
+        free(free_list);
+        free(workers);
+        free(ids);
+        return false;
+    }
+
+    BatchQueue queue = {.store = store, .ring = ring, .ring_size = pool_size,
+                        .free_list = free_list, .free_count = pool_size};
+    for (size_t i = 0; i < pool_size; i++) free_list[i] = &pool[i];
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.has_full, NULL);
+    pthread_cond_init(&queue.has_free, NULL);
+
+    *report = (BatchReport){0};
+    uint64_t start = now_ns();
+
+    unsigned started = 0;
+    for (; started < threads; started++) {
+        workers[started].queue = &queue;
+        if (pthread_create(&ids[started], NULL, run_batch_worker, &workers[started]) != 0) break;
+    }
+
+    if (started > 0) {
+        size_t too_long = 0;
+        for (;;) {
+            pthread_mutex_lock(&queue.lock);
+            while (queue.free_count == 0) pthread_cond_wait(&queue.has_free, &queue.lock);
+            AttemptBatch* batch = queue.free_list[--queue.free_count];
+            pthread_mutex_unlock(&queue.lock);
+
+            fill_batch(batch, attempts, &too_long);
+
+            pthread_mutex_lock(&queue.lock);
+            if (batch->count == 0) {
+                queue.free_list[queue.free_count++] = batch;
+            } else {
+                queue.ring[(queue.head + queue.queued) % queue.ring_size] = batch;
+                queue.queued++;
+                pthread_cond_signal(&queue.has_full);
+            }
+            pthread_mutex_unlock(&queue.lock);
+            if (batch->count < ATTEMPTS_PER_BATCH) break;
+        }
+        report->malformed = too_long;
+    }
+
+    pthread_mutex_lock(&queue.lock);
+    queue.done = true;
+    pthread_cond_broadcast(&queue.has_full);
+    pthread_mutex_unlock(&queue.lock);
+
+    // Merge what every worker counted
+    uint64_t latency[LATENCY_BUCKETS] = {0};
+    uint64_t max_ns = 0;
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(ids[t], NULL);
+        const WorkerTotals* totals = &workers[t].totals;
+        report->accepted += totals->accepted;
+        report->wrong_password += totals->wrong_password;
+        report->unknown_user += totals->unknown_user;
+        report->malformed += totals->malformed;
+        if (totals->max_ns > max_ns) max_ns = totals->max_ns;
+        for (size_t i = 0; i < LATENCY_BUCKETS; i++) latency[i] += totals->latency[i];
+    }
+    report->seconds = (double)(now_ns() - start) * 1e-9;
+
+    size_t verified = report->accepted + report->wrong_password + report->unknown_user;
+    report->attempts = verified + report->malformed;
+    report->p50_ns = latency_percentile(latency, verified, 0.50);
+    report->p90_ns = latency_percentile(latency, verified, 0.90);
+    report->p99_ns = latency_percentile(latency, verified, 0.99);
+    report->p999_ns = latency_percentile(latency, verified, 0.999);
+    report->max_ns = (double)max_ns;
+
+    pthread_cond_destroy(&queue.has_free);
+    pthread_cond_destroy(&queue.has_full);
+    pthread_mutex_destroy(&queue.lock);
+    free(pool);
+    free(ring);
+    free(free_list);
+    free(workers);
+    free(ids);
+    return started > 0;
+}
@@ -0,0 +1,35 @@
+#ifndef HASHMAP_CREDENTIAL_BATCH_H
+#define HASHMAP_CREDENTIAL_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "CredentialStore.h"
+
+// Batch verification: login attempts are streamed from a file, one per line
+//   username:password
+// The reading thread cuts them into batches and worker threads verify the
+// batches against a loaded CredentialStore.
+#define ATTEMPTS_PER_BATCH 4096
+#define MAX_ATTEMPT_LINE (MAX_USERNAME + 1 + MAX_PASSWORD + 2)
+#define MAX_BATCH_THREADS 64
+
+typedef struct {
+    size_t attempts;
+    size_t accepted;
+    size_t wrong_password;
+    size_t unknown_user;
+    size_t malformed;          // No ':' or longer than MAX_ATTEMPT_LINE
+    double seconds;            // Wall clock, reading included
+    // Time to verify one attempt, from the merged latency histogram
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+} BatchReport;
+
+// Reads `attempts` to the end. False if the threads could not be started.
+bool verify_attempts(const CredentialStore* store, FILE* attempts, unsigned threads, BatchReport* report);
+
+#endif //HASHMAP_CREDENTIAL_BATCH_H
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "CredentialStore.h"
+#include "Hash.h"
+
+#define MAX_CREDENTIAL_LINE (MAX_USERNAME + 1 + 8 + 2)   // name, ':', hash, line break and terminator
+
+bool init_credential_store(CredentialStore* store) {
+    if (!store) return false;
+
+    *store = (CredentialStore){0};
+    return UserTable_init(&store->users, CREDENTIAL_INITIAL_CAPACITY, random_hash_seed());
+}
+
+void free_credential_store(CredentialStore* store) {
+    if (!store) return;
+    UserTable_free(&store->users);
+    for (size_t i = 0; i < store->block_count; i++) free(store->name_blocks[i]);
+    free(store->name_blocks);
+    *store = (CredentialStore){0};
+}
+
+// Keys point into the blocks, so a full block is never moved or grown
+static const char* copy_name(CredentialStore* store, const char* username, size_t length) {
+    if (store->block_count == 0 || store->block_used + length > NAME_BLOCK_SIZE) {
+        char** blocks = realloc(store->name_blocks, (store->block_count + 1) * sizeof(char*));
+        if (!blocks) return NULL;
+        store->name_blocks = blocks;
+
+        char* block = malloc(NAME_BLOCK_SIZE);
+        if (!block) return NULL;
+        store->name_blocks[store->block_count++] = block;
+        store->block_used = 0;
+    }
+
+    char* copy = store->name_blocks[store->block_count - 1] + store->block_used;
+    memcpy(copy, username, length);
+    store->block_used += length;
+    return copy;
+}
+
+bool add_user(CredentialStore* store, const char* username, size_t username_length, uint32_t password_hash) {
+    if (!store || !store->users.entries || !username || username_length == 0 || username_length >= MAX_USERNAME) {
+        return false;
+    }
+
+    UserName name = {username, (uint32_t)username_length};
+    bool inserted;
+    UserTableEntry* entry = UserTable_insert(&store->users, name, password_hash, &inserted);
+    if (!entry) return false;
+    if (!inserted) {
+        entry->value = password_hash;
+        return true;
+    }
+
+    // The key still points at the caller's text, give it a copy of its own
+    entry->key.data = copy_name(store, username, username_length);
+    if (!entry->key.data) {
+        UserTable_remove_entry(&store->users, entry);
+        return false;
+    }
+    return true;
+}
+
+static bool parse_hex32(const char* text, size_t length, uint32_t* value) {
+    if (length == 0 || length > 8) return false;
+
+    uint32_t result = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (uint32_t)(c - 'A' + 10);
+        else return false;
+        result = result << 4 | digit;
+    }
+    *value = result;
+    return true;
+}
+
+size_t load_credentials(CredentialStore* store, FILE* file, size_t* rejected) {
+    if (!store || !file) return 0;
+
+    char line[MAX_CREDENTIAL_LINE];
+    size_t added = 0;
+    size_t bad = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] != '\n' && !feof(file)) {
+            // Longer than any valid line, drop the rest of it
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n') {}
+            bad++;
+            continue;
+        }
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) length--;
+        if (length == 0 || line[0] == '#') continue;
+
+        const char* colon = memchr(line, ':', length);
+        uint32_t password_hash;
+        if (!colon || !parse_hex32(colon + 1, length - (size_t)(colon - line) - 1, &password_hash)
+            || !add_user(store, line, (size_t)(colon - line), password_hash)) {
+            bad++;
+            continue;
+        }
+        added++;
+    }
+
+    if (rejected) *rejected = bad;
+    return added;
+}
+
+VerifyResult verify_user(const CredentialStore* store, const char* username, size_t username_length,
+                         const char* password, size_t password_length) {
+    if (!store || !username || !password || username_length >= MAX_USERNAME) return VERIFY_UNKNOWN_USER;
+
+    UserName name = {username, (uint32_t)username_length};
+    const UserTableEntry* entry = UserTable_find(&store->users, name);
+    if (!entry) return VERIFY_UNKNOWN_USER;
+
+    return jenkins_hash(password, password_length) == entry->value ? VERIFY_OK : VERIFY_WRONG_PASSWORD;
+}
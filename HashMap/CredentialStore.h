@@ -0,0 +1,65 @@
+#ifndef HASHMAP_CREDENTIAL_STORE_H
+#define HASHMAP_CREDENTIAL_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "Hash.h"
+#include "HashTable.h"
+
+// User table for verify_credentials, keyed by the hash of the username.
+// Filled once by load_credentials and only read afterwards, so any number
+// of threads can verify against it at the same time without locking.
+#define MAX_USERNAME 50
+#define MAX_PASSWORD 50
+#define CREDENTIAL_INITIAL_CAPACITY 1024
+#define NAME_BLOCK_SIZE 65536      // Usernames are copied into blocks of this size that never move
+
+// Points into the store's name blocks, or at the caller's text for a lookup
+typedef struct {
+    const char* data;
+    uint32_t length;
+} UserName;
+
+static inline uint32_t user_name_hash(UserName name, uint64_t seed) {
+    return jenkins_hash_seeded(name.data, name.length, seed);
+}
+
+static inline bool user_name_equals(UserName a, UserName b) {
+    return a.length == b.length && memcmp(a.data, b.data, a.length) == 0;
+}
+
+// Username to jenkins_hash of the password, like stored_password_hash in main
+DEFINE_HASH_TABLE(UserTable, UserName, uint32_t, user_name_hash, user_name_equals)
+
+typedef struct {
+    UserTable users;           // Seeded at init, users pick their names
+    char** name_blocks;
+    size_t block_count;
+    size_t block_used;         // Bytes taken in the last block
+} CredentialStore;
+
+typedef enum {
+    VERIFY_OK,
+    VERIFY_WRONG_PASSWORD,
+    VERIFY_UNKNOWN_USER,
+} VerifyResult;
+
+bool init_credential_store(CredentialStore* store);
+void free_credential_store(CredentialStore* store);
+
+// Adds or replaces a user. Not thread safe, load everything before verifying.
+bool add_user(CredentialStore* store, const char* username, size_t username_length, uint32_t password_hash);
+
+// Bulk loader, one user per line:
+//   username:password_hash     (hash as 8 hex digits)
+// Blank lines and lines starting with '#' are skipped. Returns the number of
+// users added, malformed lines are counted in `rejected` if it is not NULL.
+size_t load_credentials(CredentialStore* store, FILE* file, size_t* rejected);
+
+VerifyResult verify_user(const CredentialStore* store, const char* username, size_t username_length,
+                         const char* password, size_t password_length);
+
+#endif //HASHMAP_CREDENTIAL_STORE_H
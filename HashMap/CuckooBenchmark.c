@@ -0,0 +1,179 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Inventory.h"
+#include "InventoryStats.h"
+#include "CuckooInventory.h"
+
+/*
+ * Cuckoo against linear probing as the table fills up
+ * Usage: CuckooBenchmark [slots]
+ * Both tables get the same number of slots and are filled to each load
+ * factor in turn, then looked up with random names that are there (hits)
+ * and random names that are not (misses). Next to the times, the worst
+ * case: the longest probe a stored item needs and the longest run of
+ * occupied slots a miss may have to walk in the linear table, against the
+ * fixed two buckets of the cuckoo one.
+ */
+
+#define DEFAULT_SLOTS (1u << 20)
+#define LOOKUPS 2000000
+#define NAME_LENGTH 24
+
+static const double load_factors[] = {0.50, 0.60, 0.70, 0.80, 0.85, 0.90, 0.95};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+typedef struct {
+    char (*names)[NAME_LENGTH];
+    size_t count;
+    uint32_t* order;           // LOOKUPS random indexes into names, the same for both tables
+} NameSet;
+
+static bool make_names(NameSet* set, const char* prefix, size_t count, uint32_t seed) {
+    set->names = malloc(count * NAME_LENGTH);
+    set->order = malloc(LOOKUPS * sizeof(uint32_t));
+    set->count = count;
+    if (!set->names || !set->order) return false;
+
+    for (size_t i = 0; i < count; i++) {
+        snprintf(set->names[i], NAME_LENGTH, "%s-%zu", prefix, i);
+    }
+    uint32_t state = seed;
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        set->order[i] = next_random(&state) % (uint32_t)count;
+    }
+    return true;
+}
+
+static void free_names(NameSet* set) {
+    free(set->names);
+    free(set->order);
+}
+
+// ns per lookup, `found` is checked by the caller so nothing gets optimized away
+static double time_linear(ItemDatabase* db, const NameSet* set, size_t* found) {
+    size_t hits = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        if (find_item(db, set->names[set->order[i]])) hits++;
+    }
+    double elapsed = now_seconds() - start;
+    *found = hits;
+    return elapsed / LOOKUPS * 1e9;
+}
+
+static double time_cuckoo(const CuckooItemDatabase* db, const NameSet* set, size_t* found) {
+    size_t hits = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        if (cuckoo_find_item(db, set->names[set->order[i]])) hits++;
+    }
+    double elapsed = now_seconds() - start;
+    *found = hits;
+    return elapsed / LOOKUPS * 1e9;
+}
+
+static void bench_load(size_t slots, double load_factor, const NameSet* stored, const NameSet* missing) {
+    size_t count = (size_t)((double)slots * load_factor);
+    NameSet present = *stored;
+    present.count = count;
+    // Hits only pick from the names that made it in at this load
+    uint32_t* order = malloc(LOOKUPS * sizeof(uint32_t));
+    if (!order) return;
+    for (size_t i = 0; i < LOOKUPS; i++) order[i] = stored->order[i] % (uint32_t)count;
+    present.order = order;
+
+    ItemDatabaseOptions options = {
+            .initial_capacity = slots,
+            .max_load_factor = 0.95f,
+            .probe_mode = PROBE_LINEAR,
+            .hash_function = HASH_JENKINS_SEEDED,
+            .reseed_threshold = FLT_MAX,   // Keep the clusters linear probing builds up
+    };
+    ItemDatabase linear;
+    CuckooItemDatabase cuckoo;
+    options.seed = random_hash_seed();
+    if (!init_item_database_with(&linear, &options)) {
+        free(order);
+        return;
+    }
+    options.max_load_factor = 0.98f;
+    if (!init_cuckoo_item_database(&cuckoo, &options)) {
+        free_item_database(&linear);
+        free(order);
+        return;
+    }
+
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) add_item(&linear, present.names[i], (int)i, 100);
+    double linear_add = (now_seconds() - start) / (double)count * 1e9;
+    start = now_seconds();
+    for (size_t i = 0; i < count; i++) cuckoo_add_item(&cuckoo, present.names[i], (int)i, 100);
+    double cuckoo_add = (now_seconds() - start) / (double)count * 1e9;
+
+    size_t linear_hits, linear_misses, cuckoo_hits, cuckoo_misses;
+    double linear_hit = time_linear(&linear, &present, &linear_hits);
+    double linear_miss = time_linear(&linear, missing, &linear_misses);
+    double cuckoo_hit = time_cuckoo(&cuckoo, &present, &cuckoo_hits);
+    double cuckoo_miss = time_cuckoo(&cuckoo, missing, &cuckoo_misses);
+
+    TableHealth health = item_database_health(&linear);
+    printf("| %4.2f | %7.1f %7.1f | %7.1f %7.1f | %5zu %7zu | %7.1f %7.1f | %7.2f %7.2f | %9.2f %7zu |%s\n",
+           load_factor,
+           linear_add, cuckoo_add,
+           linear_hit, cuckoo_hit,
+           health.probes.max_probe_length, health.longest_cluster,
+           linear_miss, cuckoo_miss,
+           health.load_factor, cuckoo_item_database_load_factor(&cuckoo),
+           (double)cuckoo.kicks / (double)count, cuckoo.longest_kick_chain,
+           linear_hits != LOOKUPS || cuckoo_hits != LOOKUPS || linear_misses || cuckoo_misses
+                   ? " lookups disagree" : "");
+
+    free_item_database(&linear);
+    free_cuckoo_item_database(&cuckoo);
+    free(order);
+}
+
+int main(int argc, char* argv[]) {
+    size_t slots = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_SLOTS;
+    // Both tables round up to a power of two, use that so the loads match
+    size_t rounded = GROUP_WIDTH;
+    while (rounded < slots) rounded <<= 1;
+    slots = rounded;
+
+    NameSet stored, missing;
+    if (!make_names(&stored, "item", slots, 0x2545f491u) || !make_names(&missing, "missing", slots, 0x9e3779b9u)) {
+        printf("Could not allocate %zu names\n", slots);
+        return 1;
+    }
+
+    printf("%zu slots, %d lookups per column, ns per operation\n", slots, LOOKUPS);
+    printf("Worst: slots probed by the farthest stored item, longest run of occupied slots\n");
+    printf("Kicks: residents moved per add and in the longest chain; Load: where each table ended\n\n");
+    printf("+------+-----------------+-----------------+---------------+-----------------+-----------------+-------------------+\n");
+    printf("| Load | Add lin  cuckoo | Hit lin  cuckoo | Worst lin     | Miss lin cuckoo | Load lin cuckoo | Kicks/add  max    |\n");
+    printf("+------+-----------------+-----------------+---------------+-----------------+-----------------+-------------------+\n");
+    for (size_t i = 0; i < sizeof(load_factors) / sizeof(load_factors[0]); i++) {
+        bench_load(slots, load_factors[i], &stored, &missing);
+    }
+    printf("+------+-----------------+-----------------+---------------+-----------------+-----------------+-------------------+\n");
+
+    free_names(&stored);
+    free_names(&missing);
+    return 0;
+}
@@ -0,0 +1,323 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "CuckooInventory.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_M_X64)
+#define PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+#define CACHE_LINE 64
+#define MIN_BUCKETS 4
+#define MAX_CUCKOO_LOAD_FACTOR 0.98f
+
+/*
+ * Where a name can live:
+ * - its first bucket is the low bits of its hash
+ * - its second bucket is the first one xor an offset mixed from the whole
+ *   hash. The offset is odd, so the two never coincide, and xor makes the
+ *   pair symmetric: a resident's other bucket follows from the bucket it is
+ *   in and its stored hash, without touching or rehashing its name.
+ */
+static size_t other_bucket(size_t bucket, uint32_t hash, size_t mask) {
+    return (bucket ^ (hash_displace(hash, 1) | 1)) & mask;
+}
+
+// xorshift, only has to spread kicks over the slots
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Bit i is set when slot i of the bucket holds `hash`
+static unsigned bucket_match(const CuckooBucket* bucket, uint32_t hash) {
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128i hashes = _mm_load_si128((const __m128i*)bucket->hashes);
+    __m128i matches = _mm_cmpeq_epi32(hashes, _mm_set1_epi32((int)hash));
+    return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(matches));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+        if (bucket->hashes[i] == hash) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static const GameItem* search_bucket(const CuckooItemDatabase* db, const CuckooBucket* bucket,
+                                     const char* name, uint32_t hash) {
+    unsigned matches = bucket_match(bucket, hash);
+    for (int i = 0; matches; i++, matches >>= 1) {
+        if (!(matches & 1)) continue;
+        uint32_t index = bucket->items[i];
+        // Free slots hold hash 0, their index tells them apart
+        if (index != CUCKOO_FREE_SLOT && strcmp(db->items[index].name, name) == 0) {
+            return &db->items[index];
+        }
+    }
+    return NULL;
+}
+
+static bool place_in_free_slot(CuckooBucket* bucket, uint32_t hash, uint32_t index) {
+    for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) {
+        if (bucket->items[i] == CUCKOO_FREE_SLOT) {
+            bucket->hashes[i] = hash;
+            bucket->items[i] = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool alloc_buckets(CuckooItemDatabase* db, size_t bucket_count) {
+    // Over-allocate by a line and align by hand, aligned_alloc is not everywhere
+    void* memory = malloc(bucket_count * sizeof(CuckooBucket) + CACHE_LINE);
+    if (!memory) return false;
+
+    db->bucket_memory = memory;
+    db->buckets = (CuckooBucket*)(((uintptr_t)memory + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1));
+    db->bucket_count = bucket_count;
+    for (size_t b = 0; b < bucket_count; b++) {
+        memset(db->buckets[b].hashes, 0, sizeof(db->buckets[b].hashes));
+        for (int i = 0; i < CUCKOO_BUCKET_SLOTS; i++) db->buckets[b].items[i] = CUCKOO_FREE_SLOT;
+    }
+    return true;
+}
+
+typedef struct {
+    size_t bucket;
+    int slot;
+} Kick;
+
+/*
+ * Put items[index] in one of its buckets, kicking residents out to their
+ * other bucket when both are full. Each kick swaps the homeless entry with
+ * a random resident of the bucket it is trying. If the chain runs out of
+ * kicks, the swaps are undone in reverse, so the table is exactly as it was
+ * and the caller can grow it.
+ */
+static bool place_item(CuckooItemDatabase* db, uint32_t index) {
+    size_t mask = db->bucket_count - 1;
+    uint32_t hash = db->item_hashes[index];
+    size_t first = hash & mask;
+    size_t second = other_bucket(first, hash, mask);
+
+    if (place_in_free_slot(&db->buckets[first], hash, index)) return true;
+    if (place_in_free_slot(&db->buckets[second], hash, index)) return true;
+
+    Kick path[CUCKOO_MAX_KICKS];
+    size_t bucket = next_random(&db->random_state) & 1 ? second : first;
+
+    for (size_t kicks = 0; kicks < CUCKOO_MAX_KICKS; kicks++) {
+        CuckooBucket* target = &db->buckets[bucket];
+        int slot = (int)(next_random(&db->random_state) % CUCKOO_BUCKET_SLOTS);
+
+        uint32_t evicted_hash = target->hashes[slot];
+        uint32_t evicted_index = target->items[slot];
+        target->hashes[slot] = hash;
+        target->items[slot] = index;
+        path[kicks] = (Kick){bucket, slot};
+        hash = evicted_hash;
+        index = evicted_index;
+
+        bucket = other_bucket(bucket, hash, mask);
+        if (place_in_free_slot(&db->buckets[bucket], hash, index)) {
+            db->kicks += kicks + 1;
+            if (kicks + 1 > db->longest_kick_chain) db->longest_kick_chain = kicks + 1;
+            return true;
+        }
+    }
+
+    // Undo: swapping back along the path hands the original entry back last
+    for (size_t k = CUCKOO_MAX_KICKS; k-- > 0;) {
+        CuckooBucket* target = &db->buckets[path[k].bucket];
+        uint32_t resident_hash = target->hashes[path[k].slot];
+        uint32_t resident_index = target->items[path[k].slot];
+        target->hashes[path[k].slot] = hash;
+        target->items[path[k].slot] = index;
+        hash = resident_hash;
+        index = resident_index;
+    }
+    return false;
+}
+
+static void rehash_items(CuckooItemDatabase* db) {
+    for (size_t i = 0; i < db->count; i++) {
+        db->item_hashes[i] = db->hash(db->items[i].name, strlen(db->items[i].name), db->seed);
+    }
+}
+
+/*
+ * Place every item again in a table with at least `bucket_count` buckets,
+ * doubling up to CUCKOO_MAX_REBUILD_GROWS times if some chain still runs out
+ * of kicks. Both buckets of a name come from its one hash, so more than
+ * 2 * CUCKOO_BUCKET_SLOTS names sharing a hash fit in no table at all. For
+ * that a seeded hash gets a new seed, like ItemDatabase's reseed, up to
+ * CUCKOO_MAX_RESEEDS times. Failing that, the table, seed and hashes are
+ * left as they were.
+ */
+static bool rebuild(CuckooItemDatabase* db, size_t bucket_count) {
+    CuckooBucket* old_buckets = db->buckets;
+    void* old_memory = db->bucket_memory;
+    size_t old_count = db->bucket_count;
+    uint64_t old_seed = db->seed;
+
+    bool placed = false;
+    bool out_of_memory = false;
+    for (int reseeds = 0; !placed && !out_of_memory && reseeds <= CUCKOO_MAX_RESEEDS; reseeds++) {
+        if (reseeds > 0) {
+            if (!hash_function_is_seeded(db->hash_id)) break;
+            db->seed = random_hash_seed();
+            rehash_items(db);
+            db->reseeds++;
+        }
+
+        size_t count = bucket_count;
+        for (int grows = 0; !placed && grows <= CUCKOO_MAX_REBUILD_GROWS; grows++, count *= 2) {
+            if (!alloc_buckets(db, count)) {
+                out_of_memory = true;
+                break;
+            }
+
+            size_t done = 0;
+            while (done < db->count && place_item(db, (uint32_t)done)) done++;
+            placed = done == db->count;
+            if (!placed) free(db->bucket_memory);
+        }
+    }
+
+    if (!placed) {
+        db->buckets = old_buckets;
+        db->bucket_memory = old_memory;
+        db->bucket_count = old_count;
+        if (db->seed != old_seed) {
+            db->seed = old_seed;
+            rehash_items(db);
+        }
+        return false;
+    }
+
+    free(old_memory);
+    return true;
+}
+
+static bool over_load(const CuckooItemDatabase* db, size_t count) {
+    return (float)count > (float)(db->bucket_count * CUCKOO_BUCKET_SLOTS) * db->max_load_factor;
+}
+
+bool init_cuckoo_item_database(CuckooItemDatabase* db, const ItemDatabaseOptions* options) {
+    if (!db || !options) return false;
+
+    size_t initial_capacity = options->initial_capacity ? options->initial_capacity : INITIAL_CAPACITY;
+    size_t bucket_count = MIN_BUCKETS;
+    while (bucket_count * CUCKOO_BUCKET_SLOTS < initial_capacity) bucket_count <<= 1;
+
+    float max_load_factor = options->max_load_factor;
+    if (max_load_factor <= 0.1f || max_load_factor > MAX_CUCKOO_LOAD_FACTOR) {
+        max_load_factor = CUCKOO_DEFAULT_MAX_LOAD_FACTOR;
+    }
+
+    *db = (CuckooItemDatabase){0};
+    if (!alloc_buckets(db, bucket_count)) return false;
+
+    db->max_load_factor = max_load_factor;
+    db->hash_id = options->hash_function;
+    db->hash = get_hash_function(options->hash_function);
+    db->seed = options->seed;
+    if (hash_function_is_seeded(options->hash_function) && db->seed == 0) {
+        db->seed = random_hash_seed();
+    }
+    db->random_state = (uint32_t)(db->seed ^ db->seed >> 32) | 1;
+    return true;
+}
+
+void free_cuckoo_item_database(CuckooItemDatabase* db) {
+    if (!db) return;
+    free(db->bucket_memory);
+    free(db->items);
+    free(db->item_hashes);
+    *db = (CuckooItemDatabase){0};
+}
+
+static bool reserve_items(CuckooItemDatabase* db) {
+    if (db->count < db->item_capacity) return true;
+    if (db->count >= CUCKOO_FREE_SLOT) return false;
+
+    size_t capacity = db->item_capacity ? db->item_capacity * 2 : db->bucket_count * CUCKOO_BUCKET_SLOTS;
+    GameItem* items = realloc(db->items, capacity * sizeof(GameItem));
+    if (!items) return false;
+    db->items = items;
+    uint32_t* hashes = realloc(db->item_hashes, capacity * sizeof(uint32_t));
+    if (!hashes) return false;
+    db->item_hashes = hashes;
+    db->item_capacity = capacity;
+    return true;
+}
+
+bool cuckoo_add_item(CuckooItemDatabase* db, const char* name, int damage, int durability) {
+    if (!db || !name || !db->buckets) return false;
+
+    GameItem item = {0};
+    strncpy(item.name, name, MAX_ITEM_NAME - 1);
+    item.damage = damage;
+    item.durability = durability;
+
+    if (cuckoo_find_item(db, item.name)) return false;
+    if (!reserve_items(db)) return false;
+    if (over_load(db, db->count + 1) && !rebuild(db, db->bucket_count * 2)) return false;
+
+    uint32_t index = (uint32_t)db->count;
+    db->items[index] = item;
+    db->item_hashes[index] = db->hash(item.name, strlen(item.name), db->seed);
+
+    if (!place_item(db, index)) {
+        // Every item up to and including the new one goes into a bigger table
+        db->count++;
+        if (!rebuild(db, db->bucket_count * 2)) {
+            db->count--;
+            return false;
+        }
+        db->kick_grows++;
+        return true;
+    }
+
+    db->count++;
+    return true;
+}
+
+GameItem* cuckoo_find_item(const CuckooItemDatabase* db, const char* name) {
+    if (!db || !name || !db->buckets) return NULL;
+
+    size_t mask = db->bucket_count - 1;
+    uint32_t hash = db->hash(name, strlen(name), db->seed);
+    size_t first = hash & mask;
+    size_t second = other_bucket(first, hash, mask);
+
+    // Both buckets are all there is to read, start loading the second one now
+    PREFETCH(&db->buckets[second]);
+
+    const GameItem* item = search_bucket(db, &db->buckets[first], name, hash);
+    if (!item) item = search_bucket(db, &db->buckets[second], name, hash);
+    return (GameItem*)item;
+}
+
+size_t cuckoo_item_database_count(const CuckooItemDatabase* db) {
+    return db ? db->count : 0;
+}
+
+double cuckoo_item_database_load_factor(const CuckooItemDatabase* db) {
+    if (!db || db->bucket_count == 0) return 0.0;
+    return (double)db->count / (double)(db->bucket_count * CUCKOO_BUCKET_SLOTS);
+}
@@ -0,0 +1,62 @@
+#ifndef HASHMAP_CUCKOO_INVENTORY_H
+#define HASHMAP_CUCKOO_INVENTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "Inventory.h"
+
+// ItemDatabase with a bounded worst case: bucketized cuckoo hashing
+// Every name has two candidate buckets of CUCKOO_BUCKET_SLOTS slots, picked
+// from its hash. A lookup reads those two buckets and nothing else, so a miss
+// costs the same at 95% load as at 50%; a hit reads the item on top. An add
+// that finds both buckets full moves a resident to its other bucket, up to
+// CUCKOO_MAX_KICKS times, then grows the table instead.
+#define CUCKOO_BUCKET_SLOTS 4
+#define CUCKOO_MAX_KICKS 500
+#define CUCKOO_MAX_REBUILD_GROWS 4    // Doublings one grow tries before it gives up on the hash
+#define CUCKOO_MAX_RESEEDS 4          // New seeds one grow tries, seeded hashes only
+#define CUCKOO_DEFAULT_MAX_LOAD_FACTOR 0.9f
+#define CUCKOO_FREE_SLOT UINT32_MAX   // items[] value of an unused slot
+
+// 32 bytes, the table is aligned so a bucket never straddles a cache line
+typedef struct {
+    uint32_t hashes[CUCKOO_BUCKET_SLOTS];  // Full hash, compared before any name is
+    uint32_t items[CUCKOO_BUCKET_SLOTS];   // Index into the items array
+} CuckooBucket;
+
+typedef struct {
+    CuckooBucket* buckets;
+    void* bucket_memory;       // What malloc returned, buckets sits aligned inside it
+    size_t bucket_count;       // Power of two
+    GameItem* items;           // In insertion order, the buckets only hold indexes
+    uint32_t* item_hashes;     // hash of items[i], so growing never rehashes a name
+    size_t count;
+    size_t item_capacity;
+    float max_load_factor;     // Of bucket_count * CUCKOO_BUCKET_SLOTS
+    HashFunctionId hash_id;
+    HashFunction hash;
+    uint64_t seed;
+    uint32_t random_state;     // Picks which resident gets kicked
+    size_t kicks;              // Residents moved over all adds
+    size_t longest_kick_chain;
+    size_t kick_grows;         // Grows because a chain ran out of kicks, not because of the load factor
+    size_t reseeds;            // New seeds picked because names shared a hash
+} CuckooItemDatabase;
+
+// Takes initial_capacity (in slots), max_load_factor (up to 0.98),
+// hash_function and seed from the options, the rest does not apply here
+bool init_cuckoo_item_database(CuckooItemDatabase* db, const ItemDatabaseOptions* options);
+void free_cuckoo_item_database(CuckooItemDatabase* db);
+
+// False if the name is already there, memory ran out or too many names share
+// one hash for any table to hold them (see CUCKOO_MAX_RESEEDS)
+bool cuckoo_add_item(CuckooItemDatabase* db, const char* name, int damage, int durability);
+
+// Valid until the next cuckoo_add_item, which may move the items array
+GameItem* cuckoo_find_item(const CuckooItemDatabase* db, const char* name);
+
+size_t cuckoo_item_database_count(const CuckooItemDatabase* db);
+double cuckoo_item_database_load_factor(const CuckooItemDatabase* db);
+
+#endif //HASHMAP_CUCKOO_INVENTORY_H
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "FileHash.h"
+#include "Hash.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool hash_buffered(const char* path, JenkinsHashState* state) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    uint8_t* buffer = malloc(FILE_HASH_BUFFER_SIZE);
+    if (!buffer) {
+        fclose(file);
+        return false;
+    }
+
+    size_t got;
+    while ((got = fread(buffer, 1, FILE_HASH_BUFFER_SIZE, file)) > 0) {
+        jenkins_hash_update(state, buffer, got);
+    }
+    bool ok = !ferror(file);
+
+    free(buffer);
+    fclose(file);
+    return ok;
+}
+
+// Views are FILE_HASH_MAP_SIZE apart, a multiple of the page size and of the
+// 64 KB Windows allocation granularity, so every offset is a legal one.
+// Only one view is mapped at a time, so a 32-bit process can hash a file
+// larger than its address space.
+#ifdef _WIN32
+static bool hash_mapped(const char* path, JenkinsHashState* state, bool* mappable) {
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(handle, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (!mapping) {
+        CloseHandle(handle);
+        *mappable = false;
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t total = (uint64_t)size.QuadPart;
+    for (uint64_t offset = 0; offset < total && ok; offset += FILE_HASH_MAP_SIZE) {
+        size_t view_size = total - offset < FILE_HASH_MAP_SIZE ? (size_t)(total - offset) : FILE_HASH_MAP_SIZE;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(offset >> 32), (DWORD)offset, view_size);
+        if (!view) {
+            ok = false;
+            break;
+        }
+        jenkins_hash_update(state, view, view_size);
+        UnmapViewOfFile(view);
+    }
+
+    CloseHandle(mapping);
+    CloseHandle(handle);
+    return ok;
+}
+#else
+static bool hash_mapped(const char* path, JenkinsHashState* state, bool* mappable) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        close(fd);
+        *mappable = false;
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t total = (uint64_t)info.st_size;
+    for (uint64_t offset = 0; offset < total; offset += FILE_HASH_MAP_SIZE) {
+        size_t view_size = total - offset < FILE_HASH_MAP_SIZE ? (size_t)(total - offset) : FILE_HASH_MAP_SIZE;
+        void* view = mmap(NULL, view_size, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (view == MAP_FAILED) {
+            ok = false;
+            break;
+        }
+        // Read front to back once, let the kernel read ahead and drop pages behind us
+        posix_madvise(view, view_size, POSIX_MADV_SEQUENTIAL);
+        jenkins_hash_update(state, view, view_size);
+        munmap(view, view_size);
+    }
+
+    close(fd);
+    return ok;
+}
+#endif
+
+bool jenkins_hash_file(const char* path, uint64_t seed, FileHashMode mode, uint32_t* hash, uint64_t* length) {
+    if (!path || !hash) return false;
+
+    JenkinsHashState state;
+    jenkins_hash_init(&state, seed);
+
+    bool ok = false;
+    if (mode == FILE_HASH_MAPPED) {
+        bool mappable = true;
+        ok = hash_mapped(path, &state, &mappable);
+        // Nothing was hashed yet when a file turns out not to be mappable
+        if (!ok && !mappable) ok = hash_buffered(path, &state);
+    } else {
+        ok = hash_buffered(path, &state);
+    }
+    if (!ok) return false;
+
+    *hash = jenkins_hash_final(&state);
+    if (length) *length = state.length;
+    return true;
+}
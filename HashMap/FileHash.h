@@ -0,0 +1,23 @@
+#ifndef HASHMAP_FILE_HASH_H
+#define HASHMAP_FILE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// jenkins_hash of a whole file without holding the whole file in memory.
+// The file goes through jenkins_hash_update one large chunk at a time,
+// so the result matches jenkins_hash_seeded on the file's bytes.
+#define FILE_HASH_BUFFER_SIZE (1u << 20)   // Bytes per fread in FILE_HASH_BUFFERED
+#define FILE_HASH_MAP_SIZE (64u << 20)     // Bytes per mapped view in FILE_HASH_MAPPED
+
+typedef enum {
+    FILE_HASH_MAPPED,          // Map a window of the file at a time, no copy out of the page cache
+    FILE_HASH_BUFFERED,        // Plain reads into one reused buffer, works on pipes and devices too
+} FileHashMode;
+
+// False if the file could not be opened or read. A file that cannot be
+// mapped (empty, a pipe, ...) is read buffered instead.
+bool jenkins_hash_file(const char* path, uint64_t seed, FileHashMode mode, uint32_t* hash, uint64_t* length);
+
+#endif //HASHMAP_FILE_HASH_H
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "FileHash.h"
+#include "Hash.h"
+
+/*
+ * Fingerprint files with jenkins_hash without loading them
+ * Usage: FileHash <file>...
+ * Hashes every file once mapped and once buffered, both have to agree.
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool hash_and_time(const char* path, FileHashMode mode, uint32_t* hash) {
+    uint64_t length = 0;
+    double start = now_seconds();
+    if (!jenkins_hash_file(path, 0, mode, hash, &length)) {
+        printf("  Could not read %s\n", path);
+        return false;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("  %-8s %08x  %llu bytes", mode == FILE_HASH_MAPPED ? "mapped" : "buffered",
+           *hash, (unsigned long long)length);
+    if (elapsed > 0) printf("  %.0f MB/s", (double)length / elapsed / 1e6);
+    printf("\n");
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        // Chunks of any size add up to the one-shot hash
+        const char* message = "Network payloads arrive a piece at a time";
+        JenkinsHashState state;
+        jenkins_hash_init(&state, 0);
+        for (size_t i = 0; i < strlen(message); i += 5) {
+            size_t chunk = strlen(message) - i < 5 ? strlen(message) - i : 5;
+            jenkins_hash_update(&state, message + i, chunk);
+        }
+        printf("One shot: %08x\n", jenkins_hash(message, strlen(message)));
+        printf("Streamed: %08x\n", jenkins_hash_final(&state));
+        printf("\nUsage: %s <file>...\n", argv[0]);
+        return 0;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        uint32_t mapped, buffered;
+        printf("%s\n", argv[i]);
+        if (!hash_and_time(argv[i], FILE_HASH_MAPPED, &mapped)
+            || !hash_and_time(argv[i], FILE_HASH_BUFFERED, &buffered)) {
+            failed = 1;
+        } else if (mapped != buffered) {
+            printf("  Mapped and buffered hashes differ!\n");
+            failed = 1;
+        }
+    }
+    return failed;
+}
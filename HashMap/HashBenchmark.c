@@ -0,0 +1,188 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Hash.h"
+#include "Inventory.h"
+
+/*
+ * Compares the selectable hash functions on a key corpus
+ * Usage: HashBenchmark <corpus file> [load factor]
+ * - corpus file: one key per line
+ * - load factor: how full the ItemDatabase is when probe lengths are measured
+ * Reports hashing throughput and the probe length distribution of every
+ * function, so the table's hash can be picked from numbers.
+ */
+
+#define MAX_KEY_LENGTH 256
+#define HISTOGRAM_BUCKETS 8          // Probe lengths 1..7, the last one is 8+
+#define MIN_BENCH_SECONDS 0.2
+
+typedef struct {
+    char** keys;
+    size_t* lengths;
+    size_t count;
+    size_t total_bytes;
+} KeyCorpus;
+
+static bool load_corpus(const char* path, KeyCorpus* corpus) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    size_t capacity = 1024;
+    *corpus = (KeyCorpus){0};
+    corpus->keys = malloc(capacity * sizeof(char*));
+    corpus->lengths = malloc(capacity * sizeof(size_t));
+
+    char line[MAX_KEY_LENGTH];
+    while (corpus->keys && corpus->lengths && fgets(line, sizeof(line), file)) {
+        size_t length = strcspn(line, "\r\n");
+        if (length == 0) continue;
+        line[length] = '\0';
+
+        if (corpus->count == capacity) {
+            capacity *= 2;
+            char** keys = realloc(corpus->keys, capacity * sizeof(char*));
+            size_t* lengths = realloc(corpus->lengths, capacity * sizeof(size_t));
+            if (keys) corpus->keys = keys;
+            if (lengths) corpus->lengths = lengths;
+            if (!keys || !lengths) break;
+        }
+
+        char* key = malloc(length + 1);
+        if (!key) break;
+        memcpy(key, line, length + 1);
+
+        corpus->keys[corpus->count] = key;
+        corpus->lengths[corpus->count] = length;
+        corpus->total_bytes += length;
+        corpus->count++;
+    }
+
+    fclose(file);
+    return corpus->count > 0;
+}
+
+static void free_corpus(KeyCorpus* corpus) {
+    for (size_t i = 0; i < corpus->count; i++) {
+        free(corpus->keys[i]);
+    }
+    free(corpus->keys);
+    free(corpus->lengths);
+    *corpus = (KeyCorpus){0};
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Hash the whole corpus until enough time passed to get a stable number
+static void bench_throughput(HashFunctionId id, const KeyCorpus* corpus) {
+    HashFunction hash = get_hash_function(id);
+    uint64_t seed = random_hash_seed();
+    uint32_t checksum = 0;
+    size_t rounds = 0;
+
+    clock_t start = clock();
+    do {
+        for (size_t i = 0; i < corpus->count; i++) {
+            checksum += hash(corpus->keys[i], corpus->lengths[i], seed);
+        }
+        rounds++;
+    } while (seconds_since(start) < MIN_BENCH_SECONDS);
+    double elapsed = seconds_since(start);
+
+    double keys = (double)corpus->count * (double)rounds;
+    double bytes = (double)corpus->total_bytes * (double)rounds;
+    printf("| %-14s | %10.1f | %10.1f | %8.1f | %08x |\n",
+           hash_function_name(id),
+           keys / elapsed / 1e6,
+           bytes / elapsed / (1024.0 * 1024.0),
+           elapsed / keys * 1e9,
+           checksum);
+}
+
+// Fill a presized table with the corpus and print how long the probes get
+static void bench_probe_lengths(HashFunctionId id, ProbeMode mode, const KeyCorpus* corpus, float load_factor) {
+    // Presize so the table never grows and ends at the requested load
+    size_t capacity = GROUP_WIDTH;
+    while ((double)capacity * load_factor < (double)corpus->count) capacity <<= 1;
+
+    ItemDatabaseOptions options = {
+            .initial_capacity = capacity,
+            .max_load_factor = 0.95f,
+            .probe_mode = mode,
+            .probe_limit = UINT32_MAX,
+            .hash_function = id,
+            .reseed_threshold = FLT_MAX,   // Measure the hash as is
+    };
+
+    ItemDatabase db;
+    if (!init_item_database_with(&db, &options)) {
+        printf("Could not allocate a table of %zu slots\n", capacity);
+        return;
+    }
+
+    for (size_t i = 0; i < corpus->count; i++) {
+        add_item(&db, corpus->keys[i], 0, 0);
+    }
+
+    size_t histogram[HISTOGRAM_BUCKETS];
+    item_database_probe_histogram(&db, histogram, HISTOGRAM_BUCKETS);
+    ProbeStats stats = item_database_probe_stats(&db);
+
+    printf("| %-14s | %-10s | %4.2f | %5.2f | %5zu |",
+           hash_function_name(id),
+           mode == PROBE_ROBIN_HOOD ? "robin-hood" : "linear",
+           (double)db.table.count / (double)db.table.capacity,
+           stats.average_probe_length,
+           stats.max_probe_length);
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        printf(" %5.1f%%", 100.0 * (double)histogram[i] / (double)db.table.count);
+    }
+    printf(" |\n");
+
+    free_item_database(&db);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s <corpus file> [load factor]\n", argv[0]);
+        return 1;
+    }
+
+    float load_factor = argc > 2 ? strtof(argv[2], NULL) : DEFAULT_MAX_LOAD_FACTOR;
+    if (load_factor <= 0.1f || load_factor > 0.95f) load_factor = DEFAULT_MAX_LOAD_FACTOR;
+
+    KeyCorpus corpus;
+    if (!load_corpus(argv[1], &corpus)) {
+        printf("Could not read any keys from %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("%zu keys, %.1f bytes on average\n\n",
+           corpus.count, (double)corpus.total_bytes / (double)corpus.count);
+
+    printf("+----------------+------------+------------+----------+----------+\n");
+    printf("| Hash           | Mkeys/s    | MB/s       | ns/key   | Checksum |\n");
+    printf("+----------------+------------+------------+----------+----------+\n");
+    for (int id = 0; id < HASH_FUNCTION_COUNT; id++) {
+        bench_throughput((HashFunctionId)id, &corpus);
+    }
+    printf("+----------------+------------+------------+----------+----------+\n\n");
+
+    printf("Probe lengths in ItemDatabase (share of items found after 1..%d+ probes)\n", HISTOGRAM_BUCKETS);
+    printf("| Hash           | Mode       | Load | Avg   | Max   |");
+    for (int i = 1; i <= HISTOGRAM_BUCKETS; i++) {
+        printf(" %5d%s", i, i == HISTOGRAM_BUCKETS ? "+" : " ");
+    }
+    printf(" |\n");
+    for (int id = 0; id < HASH_FUNCTION_COUNT; id++) {
+        bench_probe_lengths((HashFunctionId)id, PROBE_LINEAR, &corpus, load_factor);
+        bench_probe_lengths((HashFunctionId)id, PROBE_ROBIN_HOOD, &corpus, load_factor);
+    }
+
+    free_corpus(&corpus);
+    return 0;
+}
@@ -1,124 +1,939 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "Inventory.h"
 
-#define TABLE_SIZE 64  // Small size for demonstration
-#define MAX_ITEM_NAME 32
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
-// Simple game item structure
-typedef struct {
-    char name[MAX_ITEM_NAME];
-    int damage;
-    int durability;
-} GameItem;
+#define MIGRATE_BUCKETS_PER_CALL 8   // Old buckets moved per add/find while resizing
+#define BATCH_WINDOW 16              // Keys in flight at once in find_items
+#define BUILD_HASH_CHUNK 64          // Names hashed per batch call in build_item_database
+#define RESEED_MIN_COUNT 64          // Smaller tables are cheap to scan anyway
+#define RESEED_MARGIN 2.0f           // Times the expected average probe length that counts as clustering
 
-// Hash table entry
-typedef struct {
-    char name[MAX_ITEM_NAME];  // Key
-    GameItem item;             // Value
-    bool is_occupied;          // Flag to check if slot is used
-} HashEntry;
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_M_X64)
+#define PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
 
-// The actual hash table
-typedef struct {
-    HashEntry entries[TABLE_SIZE];
-} ItemDatabase;
+// Hash a name with the function this database was set up with
+// The seed is passed in since old_table may still use the one before a reseed
+static uint32_t hash_name(const ItemDatabase* db, const char* name, uint64_t seed) {
+    return db->hash(name, strlen(name), seed);
+}
+
+// Low hash bits pick the bucket, the top 7 bits are the tag
+static uint8_t hash_tag(uint32_t hash) {
+    return (uint8_t)(hash >> 25);
+}
+
+static unsigned lowest_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Bit i is set when ctrl[i] == value, for the 16 bytes starting at ctrl
+static uint32_t group_match(const uint8_t* ctrl, uint8_t value) {
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    __m128i matches = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)value));
+    return (uint32_t)_mm_movemask_epi8(matches);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        if (ctrl[i] == value) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static void set_ctrl(ItemTable* table, size_t index, uint8_t value) {
+    table->ctrl[index] = value;
+    // Keep the mirror in sync so a group load near the end wraps around
+    if (index < GROUP_WIDTH) {
+        table->ctrl[table->capacity + index] = value;
+    }
+}
+
+static bool table_alloc(ItemTable* table, size_t capacity) {
+    table->entries = malloc(capacity * sizeof(HashEntry));
+    table->ctrl = malloc(capacity + GROUP_WIDTH);
+    if (!table->entries || !table->ctrl) {
+        free(table->entries);
+        free(table->ctrl);
+        table->entries = NULL;
+        table->ctrl = NULL;
+        return false;
+    }
+    memset(table->ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+    table->capacity = capacity;
+    table->count = 0;
+    table->total_distance = 0;
+    table->max_distance = 0;
+    return true;
+}
+
+static void table_free(ItemTable* table) {
+    free(table->entries);
+    free(table->ctrl);
+    table->entries = NULL;
+    table->ctrl = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    table->total_distance = 0;
+    table->max_distance = 0;
+}
+
+static void place_entry(ItemTable* table, HashEntry* slot, const HashEntry* entry) {
+    *slot = *entry;
+    table->total_distance += entry->probe_distance;
+    if (entry->probe_distance > table->max_distance) {
+        table->max_distance = entry->probe_distance;
+    }
+}
+
+// Insert a copy of `entry`, the caller makes sure there is a free slot
+static void table_insert(ItemTable* table, const HashEntry* entry, uint32_t hash, ProbeMode mode) {
+    size_t mask = table->capacity - 1;
+    size_t home = hash & mask;
+    size_t index = home;
+
+    HashEntry carry = *entry;
+    uint8_t carry_tag = hash_tag(hash);
+    carry.hash = hash;
+    carry.probe_distance = 0;
+
+    if (mode == PROBE_LINEAR) {
+        // Jump straight to the first free slot, a group at a time
+        uint32_t empty;
+        while (!(empty = group_match(&table->ctrl[index], CTRL_EMPTY))) {
+            index = (index + GROUP_WIDTH) & mask;
+        }
+        index = (index + lowest_bit(empty)) & mask;
+        carry.probe_distance = (uint32_t)hash_table_probe_distance(home, index, mask);
+    }
+
+    while (table->ctrl[index] != CTRL_EMPTY) {
+        HashEntry* slot = &table->entries[index];
+
+        // Robin Hood: take the slot from an entry that is closer to its home,
+        // then keep probing to find a new place for the one we evicted
+        if (slot->probe_distance < carry.probe_distance) {
+            HashEntry evicted = *slot;
+            uint8_t evicted_tag = table->ctrl[index];
+            table->total_distance -= evicted.probe_distance;
+            place_entry(table, slot, &carry);
+            set_ctrl(table, index, carry_tag);
+            carry = evicted;
+            carry_tag = evicted_tag;
+        }
+
+        index = (index + 1) & mask;
+        carry.probe_distance++;
+    }
+
+    place_entry(table, &table->entries[index], &carry);
+    set_ctrl(table, index, carry_tag);
+    table->count++;
+}
+
+// Take the entry at `index` out and close the hole, so every probe chain
+// still runs without gaps from its home bucket to its entry
+static void table_remove(ItemTable* table, size_t index, ProbeMode mode) {
+    size_t mask = table->capacity - 1;
+    size_t next = (index + 1) & mask;
+
+    table->total_distance -= table->entries[index].probe_distance;
+    table->count--;
+
+    if (mode == PROBE_ROBIN_HOOD) {
+        // Backward shift: the rest of the run moves one slot closer to home
+        while (table->ctrl[next] != CTRL_EMPTY && table->entries[next].probe_distance > 0) {
+            table->entries[index] = table->entries[next];
+            table->entries[index].probe_distance--;
+            table->total_distance--;
+            set_ctrl(table, index, table->ctrl[next]);
+            index = next;
+            next = (next + 1) & mask;
+        }
+    } else {
+        // Knuth's algorithm R: a later entry of the run fills the hole
+        // if its home bucket is at or before the hole
+        while (table->ctrl[next] != CTRL_EMPTY) {
+            HashEntry* entry = &table->entries[next];
+            size_t distance = entry->probe_distance;
+            if (hash_table_can_fill_hole(index, next, distance, mask)) {
+                size_t moved = distance - hash_table_probe_distance(index, next, mask);
+                table->total_distance -= distance - moved;
+                table->entries[index] = *entry;
+                table->entries[index].probe_distance = (uint32_t)moved;
+                set_ctrl(table, index, table->ctrl[next]);
+                index = next;
+            }
+            next = (next + 1) & mask;
+        }
+    }
+
+    set_ctrl(table, index, CTRL_EMPTY);
+}
+
+// Scan control bytes a group at a time, only tag and hash matches get a strcmp
+static HashEntry* table_find_grouped(const ItemTable* table, const char* name, uint32_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+    uint8_t tag = hash_tag(hash);
+
+    for (size_t probed = 0; probed < table->capacity; probed += GROUP_WIDTH) {
+        const uint8_t* group = &table->ctrl[index];
+        uint32_t matches = group_match(group, tag);
+        uint32_t empty = group_match(group, CTRL_EMPTY);
+
+        // Slots after the first free one belong to other probe chains
+        if (empty) matches &= (empty & (0u - empty)) - 1;
+
+        while (matches) {
+            HashEntry* entry = &table->entries[(index + lowest_bit(matches)) & mask];
+            if (entry->hash == hash && strcmp(entry->item.name, name) == 0) return entry;
+            matches &= matches - 1;
+        }
+
+        if (empty) break;
+        index = (index + GROUP_WIDTH) & mask;
+    }
+
+    return NULL;
+}
+
+// Find an entry or stop at the first empty slot
+static HashEntry* table_find(const ItemTable* table, const char* name, uint32_t hash, ProbeMode mode) {
+    if (!table->entries) return NULL;
+    if (mode == PROBE_LINEAR) return table_find_grouped(table, name, hash);
+
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+    uint8_t tag = hash_tag(hash);
+
+    for (uint32_t probes = 0; probes < table->capacity; probes++) {
+        uint8_t ctrl = table->ctrl[index];
+        if (ctrl == CTRL_EMPTY) break;
+
+        // Robin Hood: our item would have taken this slot, so it is not here
+        HashEntry* entry = &table->entries[index];
+        if (entry->probe_distance < probes) break;
+
+        if (ctrl == tag && entry->hash == hash && strcmp(entry->item.name, name) == 0) return entry;
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+static bool is_resizing(const ItemDatabase* db) {
+    return db->old_table.entries != NULL;
+}
+
+static bool is_cache(const ItemDatabase* db) {
+    return db->memory_budget != 0;
+}
+
+static size_t table_bytes(size_t capacity) {
+    return capacity * sizeof(HashEntry) + capacity + GROUP_WIDTH;
+}
+
+// CLOCK: sweep the slots, an item found since the last pass gets its bit
+// cleared and another round, the first one without it is evicted.
+// Ends within two sweeps since the first one clears every bit.
+static void evict_one(ItemDatabase* db) {
+    ItemTable* table = &db->table;
+    size_t mask = table->capacity - 1;
+
+    for (;;) {
+        size_t index = db->clock_hand;
+        db->clock_hand = (index + 1) & mask;
+        if (table->ctrl[index] == CTRL_EMPTY) continue;
+
+        HashEntry* entry = &table->entries[index];
+        if (entry->referenced) {
+            entry->referenced = 0;
+            continue;
+        }
+
+        table_remove(table, index, db->probe_mode);
+        db->count--;
+        db->evictions++;
+        return;
+    }
+}
+
+// Count the lookup and mark the item as recently used
+static void note_lookup(ItemDatabase* db, HashEntry* entry) {
+    if (!entry) {
+        db->misses++;
+        return;
+    }
+
+    db->hits++;
+    // Only write when the bit changes, a hot item's line stays clean
+    if (is_cache(db) && !entry->referenced) entry->referenced = 1;
+}
+
+#ifdef ITEM_DATABASE_STATS
+// Walk the chain the way table_find does, counting slots instead of
+// comparing fast, so the lookup paths carry no counting of their own
+static size_t chain_probes(const ItemTable* table, const char* name, uint32_t hash, ProbeMode mode, bool* found) {
+    *found = false;
+    if (!table->entries) return 0;
+
+    size_t mask = table->capacity - 1;
+    size_t index = hash & mask;
+    size_t probes = 0;
+
+    while (probes < table->capacity) {
+        probes++;
+        if (table->ctrl[index] == CTRL_EMPTY) break;
+
+        const HashEntry* entry = &table->entries[index];
+        if (mode == PROBE_ROBIN_HOOD && entry->probe_distance < probes - 1) break;
+        if (entry->hash == hash && strcmp(entry->item.name, name) == 0) {
+            *found = true;
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return probes;
+}
+#endif
+
+// Instrumented builds only: record how long the lookup for `name` was.
+// A NULL name is a lookup the filter answered without the table.
+static void count_lookup(ItemDatabase* db, const char* name, const HashEntry* entry) {
+#ifdef ITEM_DATABASE_STATS
+    size_t probes = 0;
+    if (name) {
+        bool found;
+        probes = chain_probes(&db->table, name, hash_name(db, name, db->seed), db->probe_mode, &found);
+        if (!found && is_resizing(db)) {
+            probes += chain_probes(&db->old_table, name, hash_name(db, name, db->old_seed), db->probe_mode, &found);
+        }
+    }
+
+    LookupStats* stats = &db->lookup_stats;
+    size_t bucket = probes < LOOKUP_HISTOGRAM_BUCKETS ? probes : LOOKUP_HISTOGRAM_BUCKETS - 1;
+    stats->lookups++;
+    stats->probes += probes;
+    if (probes > stats->max_probes) stats->max_probes = probes;
+    if (entry) {
+        stats->hits++;
+        stats->hit_probes[bucket]++;
+    } else {
+        stats->misses++;
+        stats->miss_probes[bucket]++;
+    }
+#else
+    (void)db;
+    (void)name;
+    (void)entry;
+#endif
+}
+
+// Move up to `buckets` slots of the old table into the new one
+static void migrate_buckets(ItemDatabase* db, size_t buckets) {
+    if (!is_resizing(db)) return;
+
+    ItemTable* old_table = &db->old_table;
+    while (buckets-- > 0 && db->migrate_index < old_table->capacity) {
+        size_t index = db->migrate_index++;
+        if (old_table->ctrl[index] == CTRL_EMPTY) continue;
+
+        const HashEntry* old_entry = &old_table->entries[index];
+
+        // The cached hash only holds while the seed stays the same
+        uint32_t hash = db->old_seed == db->seed ? old_entry->hash : hash_name(db, old_entry->item.name, db->seed);
+
+        // Old slots are left untouched so probe chains there stay intact
+        table_insert(&db->table, old_entry, hash, db->probe_mode);
+    }
+
+    if (db->migrate_index == old_table->capacity) {
+        table_free(old_table);
+        db->migrate_index = 0;
+        db->old_seed = db->seed;
+    }
+}
+
+// Whether `capacity` slots take `count` items without passing the load factor
+static bool fits(size_t capacity, size_t count, float max_load_factor) {
+    return (float)count <= (float)capacity * max_load_factor;
+}
+
+static bool needs_grow(const ItemTable* table, float max_load_factor) {
+    return !fits(table->capacity, table->count + 1, max_load_factor);
+}
+
+// Move the current table into a bigger one that fits `count` items, hashes
+// stay valid since the seed does not change
+static bool regrow_table(ItemDatabase* db, size_t count) {
+    size_t capacity = db->table.capacity;
+    while (!fits(capacity, count, db->max_load_factor)) capacity <<= 1;
+
+    ItemTable bigger;
+    if (!table_alloc(&bigger, capacity)) return false;
+
+    for (size_t i = 0; i < db->table.capacity; i++) {
+        if (db->table.ctrl[i] == CTRL_EMPTY) continue;
+        table_insert(&bigger, &db->table.entries[i], db->table.entries[i].hash, db->probe_mode);
+    }
+
+    table_free(&db->table);
+    db->table = bigger;
+    return true;
+}
+
+// A filter sized for the old table fills up as the items keep coming and
+// says yes more and more often, so one sized for the new table replaces it.
+// Every name has to be in `table` by now. If the new filter cannot be
+// allocated the old one stays, it is still right, only less selective.
+static void grow_filter(ItemDatabase* db, size_t capacity) {
+    if (!db->filter.blocks) return;
+
+    size_t expected = (size_t)((float)capacity * db->max_load_factor);
+    if (expected <= db->filter.expected_items) return;
+
+    BloomFilter bigger;
+    if (!init_bloom_filter(&bigger, expected, db->filter.false_positive_rate)) return;
+
+    for (size_t i = 0; i < db->table.capacity; i++) {
+        if (db->table.ctrl[i] == CTRL_EMPTY) continue;
+        const char* name = db->table.entries[i].item.name;
+        bloom_filter_add(&bigger, name, strlen(name));
+    }
 
-// Our Jenkins hash function (simplified for game items)
-uint32_t jenkins_hash(const char* item_name) {
-    uint32_t hash = 0;
+    // The lookup counters are the database's, they carry over
+    bigger.checks = db->filter.checks;
+    bigger.rejected = db->filter.rejected;
+    bigger.false_positives = db->filter.false_positives;
+    free_bloom_filter(&db->filter);
+    db->filter = bigger;
+}
+
+// Allocate a new table and start moving items over to it, hashed with `seed`
+static bool start_rehash(ItemDatabase* db, size_t capacity, uint64_t seed) {
+    // Table filled up again before the last resize finished, finish it now.
+    // The new table holds the adds since then, so the rest of the old one
+    // may not fit next to them: a full table would leave the insert probing
+    // forever, move to a bigger one first.
+    if (is_resizing(db)) {
+        if (!fits(db->table.capacity, db->count, db->max_load_factor) && !regrow_table(db, db->count)) {
+            return false;
+        }
+        migrate_buckets(db, db->old_table.capacity);
+    }
+
+    // Everything stored ends up in the new table, plus the add that asked
+    while (!fits(capacity, db->count + 1, db->max_load_factor)) capacity <<= 1;
+    grow_filter(db, capacity);
+
+    ItemTable fresh;
+    if (!table_alloc(&fresh, capacity)) return false;
+
+    db->old_table = db->table;
+    db->table = fresh;
+    db->migrate_index = 0;
+    db->old_seed = db->seed;
+    db->seed = seed;
+
+    return true;
+}
+
+static bool start_resize(ItemDatabase* db) {
+    return start_rehash(db, db->table.capacity * 2, db->seed);
+}
+
+// Robin Hood keeps lookups short only while chains stay short,
+// so grow early when one gets past the limit. Below a quarter load a long
+// chain means colliding keys and a bigger table would not help.
+static void check_chain_limit(ItemDatabase* db) {
+    if (db->probe_mode == PROBE_ROBIN_HOOD && !is_resizing(db)
+        && db->table.max_distance >= db->probe_limit
+        && db->table.count * 4 >= db->table.capacity) {
+        start_resize(db);
+    }
+}
+
+// Collision flooding monitor: names picked to collide under the current
+// seed pile up in a few long chains, so when the average probe length gets
+// past the threshold rebuild the table under a fresh random seed.
+// The floor stops an input that clusters under every seed from causing
+// a rebuild on each insert, the count has to double before trying again.
+static void check_probe_lengths(ItemDatabase* db) {
+    if (!hash_function_is_seeded(db->hash_id) || is_resizing(db)) return;
+
+    const ItemTable* table = &db->table;
+    if (table->count < RESEED_MIN_COUNT || table->count <= db->reseed_floor) return;
+
+    double average = 1.0 + (double)table->total_distance / (double)table->count;
+    if (average <= db->reseed_threshold) return;
+
+    // The new table takes every item back plus the adds made while the old
+    // one drains, a table already near its limit is doubled
+    size_t capacity = table->capacity;
+    if (!fits(capacity, db->count + capacity / MIGRATE_BUCKETS_PER_CALL, db->max_load_factor)) {
+        capacity *= 2;
+    }
+
+    if (start_rehash(db, capacity, random_hash_seed())) {
+        db->reseed_floor = db->count * 2;
+        db->reseeds++;
+    }
+}
+
+// A hit at load a probes (1 + 1 / (1 - a)) / 2 slots on average with linear
+// probing, Robin Hood only moves entries around so it has the same average.
+// Chains RESEED_MARGIN times longer than that at the fullest the table gets
+// are clustering, not bad luck.
+static float default_reseed_threshold(float max_load_factor) {
+    float expected = 0.5f * (1.0f + 1.0f / (1.0f - max_load_factor));
+    float threshold = expected * RESEED_MARGIN;
+    return threshold > DEFAULT_RESEED_THRESHOLD ? threshold : DEFAULT_RESEED_THRESHOLD;
+}
+
+// Initialize the item database with custom sizing and probing
+bool init_item_database_with(ItemDatabase* db, const ItemDatabaseOptions* options) {
+    if (!db || !options) return false;
+
+    // Round up to a power of two so we can mask instead of using modulo
+    size_t initial_capacity = options->initial_capacity ? options->initial_capacity : INITIAL_CAPACITY;
+    size_t capacity = GROUP_WIDTH;
+    while (capacity < initial_capacity) capacity <<= 1;
+
+    float max_load_factor = options->max_load_factor;
+    if (max_load_factor <= 0.1f || max_load_factor > 0.95f) {
+        max_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    }
 
-    while (*item_name) {
-        hash += *item_name;
-        hash += (hash << 10);
-        hash ^= (hash >> 6);
-        item_name++;
+    // A cache gets the biggest table that fits the budget and never grows
+    if (options->memory_budget) {
+        if (table_bytes(GROUP_WIDTH) > options->memory_budget) return false;
+        capacity = GROUP_WIDTH;
+        while (table_bytes(capacity * 2) <= options->memory_budget) capacity <<= 1;
     }
 
-    hash += (hash << 3);
-    hash ^= (hash >> 11);
-    hash += (hash << 15);
+    db->old_table = (ItemTable){0};
+    db->migrate_index = 0;
+    db->count = 0;
+    db->max_load_factor = max_load_factor;
+    db->probe_mode = options->probe_mode;
+    db->probe_limit = options->probe_limit ? options->probe_limit : DEFAULT_PROBE_LIMIT;
+    db->hash_id = options->hash_function;
+    db->hash = get_hash_function(options->hash_function);
+    db->seed = options->seed;
+    if (hash_function_is_seeded(db->hash_id) && db->seed == 0) {
+        db->seed = random_hash_seed();
+    }
+    db->old_seed = db->seed;
+    db->reseed_threshold = options->reseed_threshold > 1.0f ? options->reseed_threshold
+                                                                : default_reseed_threshold(max_load_factor);
+    db->reseed_floor = 0;
+    db->reseeds = 0;
+    db->read_only = false;
+    db->memory_budget = options->memory_budget;
+    db->max_items = 0;
+    if (options->memory_budget) {
+        db->max_items = (size_t)((float)capacity * max_load_factor);
+    }
+    db->clock_hand = 0;
+    db->hits = 0;
+    db->misses = 0;
+    db->evictions = 0;
+    db->filter = (BloomFilter){0};
+#ifdef ITEM_DATABASE_STATS
+    db->lookup_stats = (LookupStats){0};
+#endif
+
+    if (options->filter_false_positive_rate > 0.0) {
+        size_t expected = options->expected_items ? options->expected_items : (size_t)((float)capacity * max_load_factor);
+        if (!init_bloom_filter(&db->filter, expected, options->filter_false_positive_rate)) return false;
+    }
 
-    return hash;
+    if (!table_alloc(&db->table, capacity)) {
+        free_bloom_filter(&db->filter);
+        return false;
+    }
+    return true;
 }
 
 // Initialize the item database
-void init_item_database(ItemDatabase* db) {
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        db->entries[i].is_occupied = false;
+bool init_item_database(ItemDatabase* db) {
+    ItemDatabaseOptions options = {0};
+    return init_item_database_with(db, &options);
+}
+
+void free_item_database(ItemDatabase* db) {
+    if (!db) return;
+    if (db->read_only) {
+        // The mapping owns the slots, close_item_database_file unmaps them
+        db->table = (ItemTable){0};
+    } else {
+        table_free(&db->table);
+        table_free(&db->old_table);
+        free_bloom_filter(&db->filter);
     }
+    db->migrate_index = 0;
+    db->count = 0;
+}
+
+// Move every item still in the old table over now, so all of them are in `table`
+void finish_item_database_resize(ItemDatabase* db) {
+    if (db && is_resizing(db)) {
+        migrate_buckets(db, db->old_table.capacity);
+    }
+}
+
+// Number of items stored, including the ones not migrated yet
+size_t item_database_count(const ItemDatabase* db) {
+    return db->count;
+}
+
+// Probe lengths of the current table, counting the home slot as one probe
+ProbeStats item_database_probe_stats(const ItemDatabase* db) {
+    ProbeStats stats = {0};
+    const ItemTable* table = &db->table;
+
+    if (table->count > 0) {
+        stats.max_probe_length = (size_t)table->max_distance + 1;
+        stats.average_probe_length = 1.0 + (double)table->total_distance / (double)table->count;
+    }
+    stats.reseeds = db->reseeds;
+
+    return stats;
+}
+
+// Lookup counters, plus the eviction count and budget use in cache mode
+CacheStats item_database_cache_stats(const ItemDatabase* db) {
+    CacheStats stats = {0};
+    stats.hits = db->hits;
+    stats.misses = db->misses;
+    stats.evictions = db->evictions;
+    stats.max_items = db->max_items;
+    stats.memory_bytes = db->table.capacity ? table_bytes(db->table.capacity) : 0;
+    if (is_resizing(db)) stats.memory_bytes += table_bytes(db->old_table.capacity);
+    stats.filter_rejected = db->filter.rejected;
+    stats.filter_false_positive_rate = bloom_filter_false_positive_rate(&db->filter);
+    return stats;
+}
+
+// Count entries by probe length: histogram[i] gets the items a lookup finds
+// after i + 1 probes, the last bucket also takes everything longer
+void item_database_probe_histogram(const ItemDatabase* db, size_t histogram[], size_t buckets) {
+    if (!db || !histogram || buckets == 0) return;
+
+    memset(histogram, 0, buckets * sizeof(size_t));
+
+    const ItemTable* table = &db->table;
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->ctrl[i] == CTRL_EMPTY) continue;
+
+        size_t bucket = table->entries[i].probe_distance;
+        histogram[bucket < buckets ? bucket : buckets - 1]++;
+    }
+}
+
+// Cache mode: the item replaces an older copy, and when the cache is full
+// the least recently found item is evicted to make room. New items start
+// without their referenced bit, so one pass over many items that are never
+// looked up again does not push out the ones that are.
+static bool add_cached_item(ItemDatabase* db, const HashEntry* entry) {
+    uint32_t hash = hash_name(db, entry->item.name, db->seed);
+
+    HashEntry* existing = table_find(&db->table, entry->item.name, hash, db->probe_mode);
+    if (existing) {
+        existing->item = entry->item;
+        return true;
+    }
+
+    if (db->count >= db->max_items) evict_one(db);
+
+    // Evicted names keep their filter bits, they only turn into false positives
+    bloom_filter_add(&db->filter, entry->item.name, strlen(entry->item.name));
+    table_insert(&db->table, entry, hash, db->probe_mode);
+    db->count++;
+    return true;
 }
 
 // Add an item to the database
 bool add_item(ItemDatabase* db, const char* name, int damage, int durability) {
-    uint32_t hash = jenkins_hash(name);
-    int index = hash % TABLE_SIZE;
+    if (!db || !name || db->read_only) return false;
+
+    // Add the item
+    HashEntry entry = {0};
+    strncpy(entry.item.name, name, MAX_ITEM_NAME - 1);
+    entry.item.damage = damage;
+    entry.item.durability = durability;
+
+    // A cache never grows or rehashes, that would need a second table's worth of memory
+    if (is_cache(db)) return add_cached_item(db, &entry);
+
+    migrate_buckets(db, MIGRATE_BUCKETS_PER_CALL);
 
-    // Simple linear probing for collision resolution
-    int original_index = index;
-    while (db->entries[index].is_occupied) {
-        index = (index + 1) % TABLE_SIZE;
-        if (index == original_index) return false; // Table is full
+    if (needs_grow(&db->table, db->max_load_factor) && !start_resize(db)) {
+        return false; // Out of memory
     }
 
-    // Add the item
-    strncpy(db->entries[index].name, name, MAX_ITEM_NAME - 1);
-    db->entries[index].item.damage = damage;
-    db->entries[index].item.durability = durability;
-    strncpy(db->entries[index].item.name, name, MAX_ITEM_NAME - 1);
-    db->entries[index].is_occupied = true;
+    bloom_filter_add(&db->filter, entry.item.name, strlen(entry.item.name));
+    table_insert(&db->table, &entry, hash_name(db, entry.item.name, db->seed), db->probe_mode);
+    db->count++;
+
+    check_chain_limit(db);
+    check_probe_lengths(db);
 
     return true;
 }
 
+// Length of a name that may fill the whole array, add_item cuts it at MAX_ITEM_NAME - 1
+static size_t item_name_length(const GameItem* item) {
+    const char* end = memchr(item->name, '\0', MAX_ITEM_NAME - 1);
+    return end ? (size_t)(end - item->name) : MAX_ITEM_NAME - 1;
+}
+
+// Hash every name up front, in chunks the batch Jenkins routine can interleave
+static void hash_item_names(const ItemDatabase* db, const GameItem items[], size_t n, uint32_t hashes[]) {
+    bool batch = db->hash_id == HASH_JENKINS_OAAT || db->hash_id == HASH_JENKINS_SEEDED;
+    uint64_t seed = db->hash_id == HASH_JENKINS_SEEDED ? db->seed : 0;
+
+    for (size_t start = 0; start < n; start += BUILD_HASH_CHUNK) {
+        size_t chunk = n - start < BUILD_HASH_CHUNK ? n - start : BUILD_HASH_CHUNK;
+        const void* keys[BUILD_HASH_CHUNK];
+        size_t lens[BUILD_HASH_CHUNK];
+        for (size_t i = 0; i < chunk; i++) {
+            keys[i] = items[start + i].name;
+            lens[i] = item_name_length(&items[start + i]);
+        }
+
+        if (batch) {
+            jenkins_hash_batch_seeded(keys, lens, chunk, seed, &hashes[start]);
+        } else {
+            for (size_t i = 0; i < chunk; i++) hashes[start + i] = db->hash(keys[i], lens[i], db->seed);
+        }
+    }
+}
+
+static bool add_items_one_by_one(ItemDatabase* db, const GameItem items[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        char name[MAX_ITEM_NAME];
+        memcpy(name, items[i].name, item_name_length(&items[i]));
+        name[item_name_length(&items[i])] = '\0';
+        if (!add_item(db, name, items[i].damage, items[i].durability)) {
+            free_item_database(db);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Bulk load for startup and catalog reloads:
+ * - the table is sized for all n items once, so it never grows on the way
+ * - all names are hashed in one pass before any slot is touched
+ * - a counting sort on the home slot puts the items in table order, so each
+ *   one goes to its home or right after the item placed before it. There is
+ *   no probing, and the slots are written front to back.
+ * Items whose run wraps past the last slot go in through table_insert once
+ * the rest are placed. Runs come out ordered by home slot, the order
+ * Robin Hood keeps them in, so the table is valid in either probe mode and
+ * its longest probe is shorter than add_item's in linear mode. Like
+ * add_item, names are not checked for duplicates. A memory budget turns the
+ * database into a cache, which picks what to keep item by item, so that
+ * case goes through add_item.
+ */
+bool build_item_database(ItemDatabase* db, const GameItem items[], size_t n, const ItemDatabaseOptions* options) {
+    if (!db || (!items && n > 0) || n >= UINT32_MAX) return false;
+
+    ItemDatabaseOptions sized = options ? *options : (ItemDatabaseOptions){0};
+    float max_load_factor = sized.max_load_factor;
+    if (max_load_factor <= 0.1f || max_load_factor > 0.95f) max_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+
+    if (!sized.memory_budget) {
+        size_t capacity = GROUP_WIDTH;
+        while (capacity < sized.initial_capacity || (double)capacity * max_load_factor < (double)n) capacity <<= 1;
+        sized.initial_capacity = capacity;
+        if (sized.expected_items < n) sized.expected_items = n;
+    }
+    if (!init_item_database_with(db, &sized)) return false;
+    if (n == 0) return true;
+    if (sized.memory_budget) return add_items_one_by_one(db, items, n);
+
+    ItemTable* table = &db->table;
+    size_t mask = table->capacity - 1;
+    uint32_t* hashes = malloc(n * sizeof(uint32_t));
+    uint32_t* order = malloc(n * sizeof(uint32_t));
+    uint32_t* starts = calloc(table->capacity + 1, sizeof(uint32_t));
+    if (!hashes || !order || !starts) {
+        // Slower but needs nothing on top of the table
+        free(hashes);
+        free(order);
+        free(starts);
+        return add_items_one_by_one(db, items, n);
+    }
+
+    hash_item_names(db, items, n, hashes);
+
+    // Counting sort on the home slot, items with the same home keep their order
+    for (size_t i = 0; i < n; i++) starts[(hashes[i] & mask) + 1]++;
+    for (size_t slot = 0; slot < table->capacity; slot++) starts[slot + 1] += starts[slot];
+    for (size_t i = 0; i < n; i++) order[starts[hashes[i] & mask]++] = (uint32_t)i;
+    free(starts);
+
+    size_t next_free = 0;
+    size_t wrapped = 0;
+    for (size_t k = 0; k < n; k++) {
+        uint32_t i = order[k];
+        size_t home = hashes[i] & mask;
+        size_t index = home > next_free ? home : next_free;
+        if (index > mask) {
+            order[wrapped++] = i;  // k has moved past this spot already
+            continue;
+        }
+
+        HashEntry entry = {.hash = hashes[i], .probe_distance = (uint32_t)(index - home), .item = items[i]};
+        entry.item.name[MAX_ITEM_NAME - 1] = '\0';
+        place_entry(table, &table->entries[index], &entry);
+        set_ctrl(table, index, hash_tag(hashes[i]));
+        table->count++;
+        next_free = index + 1;
+    }
+    for (size_t k = 0; k < wrapped; k++) {
+        HashEntry entry = {.item = items[order[k]]};
+        entry.item.name[MAX_ITEM_NAME - 1] = '\0';
+        table_insert(table, &entry, hashes[order[k]], db->probe_mode);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bloom_filter_add(&db->filter, items[i].name, item_name_length(&items[i]));
+    }
+    db->count = n;
+
+    free(hashes);
+    free(order);
+
+    check_chain_limit(db);
+    check_probe_lengths(db);
+    return true;
+}
+
 // Find an item in the database
+// The returned pointer is only valid until the next add_item/find_item call,
+// since those may move entries while a resize is in progress.
 GameItem* find_item(ItemDatabase* db, const char* name) {
-    uint32_t hash = jenkins_hash(name);
-    int index = hash % TABLE_SIZE;
+    if (!db || !name) return NULL;
 
-    // Linear probe until we find the item or an empty slot
-    int original_index = index;
-    while (db->entries[index].is_occupied) {
-        if (strcmp(db->entries[index].name, name) == 0) {
-            return &db->entries[index].item;
-        }
-        index = (index + 1) % TABLE_SIZE;
-        if (index == original_index) break; // We've searched the entire table
+    // A definite no from the filter skips the table altogether
+    if (!bloom_filter_may_contain(&db->filter, name, strlen(name))) {
+        note_lookup(db, NULL);
+        count_lookup(db, NULL, NULL);
+        return NULL;
     }
 
-    return NULL;
+    migrate_buckets(db, MIGRATE_BUCKETS_PER_CALL);
+
+    uint32_t hash = hash_name(db, name, db->seed);
+
+    HashEntry* entry = table_find(&db->table, name, hash, db->probe_mode);
+    if (!entry && is_resizing(db)) {
+        // Not migrated yet, the old table may still be on the previous seed
+        if (db->old_seed != db->seed) hash = hash_name(db, name, db->old_seed);
+        entry = table_find(&db->old_table, name, hash, db->probe_mode);
+    }
+
+    if (!entry) bloom_filter_report_false_positive(&db->filter);
+    note_lookup(db, entry);
+    count_lookup(db, name, entry);
+    return entry ? &entry->item : NULL;
 }
 
-int main() {
-    ItemDatabase game_items;
-    init_item_database(&game_items);
+// Look up many names at once, out[i] is NULL for names that are missing.
+// Keys are handled a window at a time: hash all of them and prefetch their
+// control groups, then prefetch the first candidate entry of each, and only
+// then compare names. The cache misses of independent keys overlap instead
+// of being paid one after the other. Returns how many names were found.
+// Like find_item, the pointers are valid until the next add_item/find_item.
+size_t find_items(ItemDatabase* db, const char* const names[], size_t n, GameItem* out[]) {
+    if (!db || !names || !out) return 0;
 
-    // Add some game items
-    add_item(&game_items, "Wooden Sword", 5, 100);
-    add_item(&game_items, "Iron Sword", 10, 200);
-    add_item(&game_items, "Magic Staff", 15, 150);
-    add_item(&game_items, "Legendary Blade", 50, 500);
+    migrate_buckets(db, MIGRATE_BUCKETS_PER_CALL);
 
-    // Test finding items
-    const char* items_to_find[] = {
-            "Wooden Sword",
-            "Magic Staff",
-            "Not Real Item"  // This one doesn't exist
-    };
+    const ItemTable* table = &db->table;
+    size_t mask = table->capacity - 1;
+    size_t found = 0;
 
-    // Try to find and print items
-    for (int i = 0; i < 3; i++) {
-        GameItem* found_item = find_item(&game_items, items_to_find[i]);
+    for (size_t start = 0; start < n; start += BATCH_WINDOW) {
+        size_t window = n - start < BATCH_WINDOW ? n - start : BATCH_WINDOW;
+        uint32_t hashes[BATCH_WINDOW];
+        bool maybe[BATCH_WINDOW];
 
-        if (found_item) {
-            printf("Found item: %s\n", found_item->name);
-            printf("  Damage: %d\n", found_item->damage);
-            printf("  Durability: %d\n\n", found_item->durability);
+        // Stage 1: hash everything and request the home control groups of
+        // the names the filter could not rule out
+        if (db->hash_id == HASH_JENKINS_OAAT || db->hash_id == HASH_JENKINS_SEEDED) {
+            const void* keys[BATCH_WINDOW];
+            size_t lens[BATCH_WINDOW];
+            for (size_t i = 0; i < window; i++) {
+                keys[i] = names[start + i];
+                lens[i] = strlen(names[start + i]);
+            }
+            uint64_t seed = db->hash_id == HASH_JENKINS_SEEDED ? db->seed : 0;
+            jenkins_hash_batch_seeded(keys, lens, window, seed, hashes);
         } else {
-            printf("Could not find item: %s\n\n", items_to_find[i]);
+            for (size_t i = 0; i < window; i++) {
+                hashes[i] = hash_name(db, names[start + i], db->seed);
+            }
+        }
+        for (size_t i = 0; i < window; i++) {
+            const char* name = names[start + i];
+            maybe[i] = bloom_filter_may_contain(&db->filter, name, strlen(name));
+            if (maybe[i]) PREFETCH(&table->ctrl[hashes[i] & mask]);
+        }
+
+        // Stage 2: find the first tag match in each home group and request that entry
+        for (size_t i = 0; i < window; i++) {
+            if (!maybe[i]) continue;
+            size_t home = hashes[i] & mask;
+            uint32_t matches = group_match(&table->ctrl[home], hash_tag(hashes[i]));
+            if (matches) {
+                PREFETCH(&table->entries[(home + lowest_bit(matches)) & mask]);
+            }
+        }
+
+        // Stage 3: resolve, by now the lines we need are on their way
+        for (size_t i = 0; i < window; i++) {
+            const char* name = names[start + i];
+            HashEntry* entry = NULL;
+            if (maybe[i]) {
+                entry = table_find(table, name, hashes[i], db->probe_mode);
+                if (!entry && is_resizing(db)) {
+                    uint32_t hash = db->old_seed == db->seed ? hashes[i] : hash_name(db, name, db->old_seed);
+                    entry = table_find(&db->old_table, name, hash, db->probe_mode);
+                }
+                if (!entry) bloom_filter_report_false_positive(&db->filter);
+            }
+
+            note_lookup(db, entry);
+            count_lookup(db, maybe[i] ? name : NULL, entry);
+            out[start + i] = entry ? &entry->item : NULL;
+            if (entry) found++;
         }
     }
 
-    return 0;
-}
\ No newline at end of file
+    return found;
+}
@@ -0,0 +1,153 @@
+#ifndef HASHMAP_INVENTORY_H
+#define HASHMAP_INVENTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "Hash.h"
+#include "BloomFilter.h"
+#include "HashTable.h"
+
+#define INITIAL_CAPACITY 64          // Starting number of slots (power of two)
+#define DEFAULT_MAX_LOAD_FACTOR 0.75f
+#define DEFAULT_PROBE_LIMIT 16       // Robin Hood grows the table past this probe length
+#define DEFAULT_RESEED_THRESHOLD 6.0f // Least average probe length that triggers a reseed, higher loads get more
+#define MAX_ITEM_NAME 32
+
+// Control bytes: one per slot, kept apart from the entries so a probe can
+// scan 16 of them at once and only touch entries whose tag matches
+#define GROUP_WIDTH 16
+#define CTRL_EMPTY HASH_TABLE_EMPTY   // High bit set = free slot, otherwise a 7 bit tag
+
+// Simple game item structure
+typedef struct {
+    char name[MAX_ITEM_NAME];
+    int damage;
+    int durability;
+} GameItem;
+
+// Hash table entry
+// The key is item.name, kept once. The full hash is cached next to it so
+// probes and resizes skip most strcmp and rehash calls.
+typedef struct {
+    uint32_t hash;             // hash_name of item.name under the table's seed
+    uint32_t probe_distance : 31; // Slots away from the home bucket
+    uint32_t referenced : 1;   // Cache mode: found since the clock hand last passed
+    GameItem item;             // Value, item.name is the key
+} HashEntry;
+
+typedef enum {
+    PROBE_LINEAR,              // First free slot wins
+    PROBE_ROBIN_HOOD,          // Entries closer to home give their slot to farther ones
+} ProbeMode;
+
+// Per lookup counters, compiled in with ITEM_DATABASE_STATS defined
+// (cmake -DHASHMAP_STATS=ON) and left out of the struct otherwise.
+// A probe is one slot from the home bucket on, a miss counts the slot that
+// ended the chain too. Lookups the Bloom filter rejects take 0 probes.
+#define LOOKUP_HISTOGRAM_BUCKETS 32
+
+typedef struct {
+    size_t lookups;
+    size_t hits;
+    size_t misses;
+    size_t probes;             // Over all lookups
+    size_t max_probes;
+    size_t hit_probes[LOOKUP_HISTOGRAM_BUCKETS];  // [i]: hits that took i probes, the last bucket also takes longer ones
+    size_t miss_probes[LOOKUP_HISTOGRAM_BUCKETS];
+} LookupStats;
+
+// One heap allocated array of slots
+typedef struct {
+    HashEntry* entries;
+    uint8_t* ctrl;             // capacity + GROUP_WIDTH bytes, the tail mirrors the first group
+    size_t capacity;           // Always a power of two, at least GROUP_WIDTH
+    size_t count;              // Occupied slots
+    size_t total_distance;     // Sum of probe_distance over all entries
+    uint32_t max_distance;     // Largest probe_distance ever stored
+} ItemTable;
+
+// The actual hash table
+// While growing, items live in both tables: new items go to `table` and
+// every add/find call moves a few buckets over from `old_table`.
+typedef struct {
+    ItemTable table;
+    ItemTable old_table;       // Empty unless a resize is in progress
+    size_t migrate_index;      // Next bucket of old_table to move
+    size_t count;              // Items across both tables
+    float max_load_factor;
+    ProbeMode probe_mode;
+    uint32_t probe_limit;      // Robin Hood only, see add_item
+    HashFunctionId hash_id;
+    HashFunction hash;
+    uint64_t seed;
+    uint64_t old_seed;         // Seed old_table was filled with, differs after a reseed
+    float reseed_threshold;    // Seeded hashes only, see add_item
+    size_t reseed_floor;       // No reseed until count gets past this
+    size_t reseeds;            // Times the monitor picked a new seed
+    bool read_only;            // Tables point into a mapped file, see InventoryFile.h
+    size_t memory_budget;      // Non-zero in cache mode, see add_item
+    size_t max_items;          // Cache mode: evict before going past this
+    size_t clock_hand;         // Cache mode: next slot the eviction sweep looks at
+    size_t hits;               // Lookups that found their item
+    size_t misses;
+    size_t evictions;
+    BloomFilter filter;        // Optional, blocks is NULL without one
+#ifdef ITEM_DATABASE_STATS
+    LookupStats lookup_stats;
+#endif
+} ItemDatabase;
+
+// Zeroed fields fall back to the defaults above
+typedef struct {
+    size_t initial_capacity;
+    float max_load_factor;
+    ProbeMode probe_mode;
+    uint32_t probe_limit;
+    HashFunctionId hash_function;
+    uint64_t seed;             // Seeded hashes only, 0 picks a random one
+    float reseed_threshold;    // Average probe length that makes the table pick a new seed, 0 scales it with max_load_factor
+    size_t memory_budget;      // Bytes for the slots, non-zero turns the table into a fixed size cache
+    size_t expected_items;     // Bloom filter sizing, with filter_false_positive_rate
+    double filter_false_positive_rate; // Non-zero puts a Bloom filter in front of lookups
+} ItemDatabaseOptions;
+
+typedef struct {
+    size_t max_probe_length;   // Worst case slots touched by a successful lookup
+    double average_probe_length;
+    size_t reseeds;            // Rebuilds caused by clustering, see add_item
+} ProbeStats;
+
+typedef struct {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t max_items;          // Cache mode only, 0 otherwise
+    size_t memory_bytes;       // Entries and control bytes of the current table
+    size_t filter_rejected;    // Lookups the Bloom filter answered without the table
+    double filter_false_positive_rate; // Measured, over lookups of missing names
+} CacheStats;
+
+// Setup and teardown
+bool init_item_database(ItemDatabase* db);
+bool init_item_database_with(ItemDatabase* db, const ItemDatabaseOptions* options);
+void free_item_database(ItemDatabase* db);
+void finish_item_database_resize(ItemDatabase* db);
+
+// Fresh database holding all n items, sized and filled in one pass instead of
+// n add_item calls. `options` may be NULL; its initial_capacity is raised to
+// fit n at max_load_factor. Items are copied, names are cut like add_item does.
+bool build_item_database(ItemDatabase* db, const GameItem items[], size_t n, const ItemDatabaseOptions* options);
+
+// Lookups and inserts
+bool add_item(ItemDatabase* db, const char* name, int damage, int durability);
+GameItem* find_item(ItemDatabase* db, const char* name);
+size_t find_items(ItemDatabase* db, const char* const names[], size_t n, GameItem* out[]);
+
+// Table health
+size_t item_database_count(const ItemDatabase* db);
+ProbeStats item_database_probe_stats(const ItemDatabase* db);
+void item_database_probe_histogram(const ItemDatabase* db, size_t histogram[], size_t buckets);
+CacheStats item_database_cache_stats(const ItemDatabase* db);
+
+#endif //HASHMAP_INVENTORY_H
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include "Inventory.h"
+#include "InventoryFile.h"
+#include "InventoryStats.h"
+#include "ItemCatalog.h"
+
+// Catalog items are compiled in, only items added at runtime live in the database
+static const GameItem* lookup_item(ItemDatabase* db, const char* name) {
+    const GameItem* item = find_catalog_item(name);
+    return item ? item : find_item(db, name);
+}
+
+int main() {
+    // Wooden Sword, Iron Sword, Magic Staff and Legendary Blade come from
+    // items.catalog, the crafted ones are loaded at startup in one go
+    const GameItem crafted[] = {
+            {"Crafted Dagger", 7, 80},
+            {"Crafted Bow", 12, 120},
+    };
+
+    // Most lookups that reach the database are for names that are not there,
+    // let a Bloom filter turn those away before they touch the table
+    ItemDatabaseOptions options = {.expected_items = 64, .filter_false_positive_rate = 0.01};
+    ItemDatabase game_items;
+    if (!build_item_database(&game_items, crafted, sizeof(crafted) / sizeof(crafted[0]), &options)) {
+        printf("Could not allocate the item database\n");
+        return 1;
+    }
+
+    // More can still be crafted at runtime
+    add_item(&game_items, "Crafted Shield", 0, 200);
+    printf("%zu catalog items, %zu crafted items\n\n", catalog_item_count, item_database_count(&game_items));
+
+    // Test finding items
+    const char* items_to_find[] = {
+            "Wooden Sword",
+            "Magic Staff",
+            "Crafted Bow",
+            "Not Real Item"  // This one doesn't exist
+    };
+
+    // Try to find and print items
+    for (int i = 0; i < 4; i++) {
+        const GameItem* found_item = lookup_item(&game_items, items_to_find[i]);
+
+        if (found_item) {
+            printf("Found item: %s\n", found_item->name);
+            printf("  Damage: %d\n", found_item->damage);
+            printf("  Durability: %d\n\n", found_item->durability);
+        } else {
+            printf("Could not find item: %s\n\n", items_to_find[i]);
+        }
+    }
+
+    // Same lookups in the crafted items resolved as one batch
+    GameItem* batch[4];
+    size_t found = find_items(&game_items, items_to_find, 4, batch);
+    printf("Batch lookup found %zu of 4 items among the crafted ones\n", found);
+    CacheStats stats = item_database_cache_stats(&game_items);
+    printf("Bloom filter turned away %zu lookups without touching the table\n", stats.filter_rejected);
+
+    // Save the finished table and look it up again straight from the file
+    MappedItemDatabase saved;
+    if (save_item_database(&game_items, "items.db") && open_item_database_file(&saved, "items.db")) {
+        GameItem* mapped_item = find_item(&saved.db, "Crafted Dagger");
+        printf("Mapped lookup: %s\n", mapped_item ? mapped_item->name : "not found");
+        close_item_database_file(&saved);
+    } else {
+        printf("Could not save or map items.db\n");
+    }
+
+    printf("\n");
+    dump_item_database_stats(&game_items, stdout, STATS_TEXT);
+
+    free_item_database(&game_items);
+    return 0;
+}
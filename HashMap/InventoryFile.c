@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "InventoryFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t align_up(uint64_t offset) {
+    return (offset + ITEM_FILE_ALIGNMENT - 1) & ~(uint64_t)(ITEM_FILE_ALIGNMENT - 1);
+}
+
+static bool write_padding(FILE* file, uint64_t from, uint64_t to) {
+    static const uint8_t zeros[ITEM_FILE_ALIGNMENT] = {0};
+    return from == to || fwrite(zeros, 1, (size_t)(to - from), file) == to - from;
+}
+
+bool save_item_database(ItemDatabase* db, const char* path) {
+    if (!db || !path || !db->table.entries) return false;
+
+    finish_item_database_resize(db);
+    const ItemTable* table = &db->table;
+
+    ItemFileHeader header = {0};
+    memcpy(header.magic, ITEM_FILE_MAGIC, sizeof(header.magic));
+    header.version = ITEM_FILE_VERSION;
+    header.byte_order = ITEM_FILE_BYTE_ORDER;
+    header.header_size = sizeof(ItemFileHeader);
+    header.entry_size = sizeof(HashEntry);
+    header.group_width = GROUP_WIDTH;
+    header.hash_function = (uint32_t)db->hash_id;
+    header.probe_mode = (uint32_t)db->probe_mode;
+    header.seed = db->seed;
+    header.capacity = table->capacity;
+    header.count = table->count;
+    header.total_distance = table->total_distance;
+    header.max_distance = table->max_distance;
+    header.entries_offset = align_up(sizeof(ItemFileHeader));
+    header.ctrl_offset = align_up(header.entries_offset + table->capacity * sizeof(HashEntry));
+    header.file_size = header.ctrl_offset + table->capacity + GROUP_WIDTH;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    // Free slots hold whatever malloc gave us, write them as zeros instead
+    HashEntry empty = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+              && write_padding(file, sizeof(header), header.entries_offset);
+    for (size_t i = 0; ok && i < table->capacity; i++) {
+        const HashEntry* entry = table->ctrl[i] == CTRL_EMPTY ? &empty : &table->entries[i];
+        ok = fwrite(entry, sizeof(HashEntry), 1, file) == 1;
+    }
+    ok = ok && write_padding(file, header.entries_offset + table->capacity * sizeof(HashEntry), header.ctrl_offset)
+         && fwrite(table->ctrl, 1, table->capacity + GROUP_WIDTH, file) == table->capacity + GROUP_WIDTH;
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(path);
+    return ok;
+}
+
+// Everything in the header is checked before any offset in it is followed
+static bool header_is_valid(const ItemFileHeader* header, size_t size) {
+    if (size < sizeof(ItemFileHeader)) return false;
+    if (memcmp(header->magic, ITEM_FILE_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != ITEM_FILE_VERSION || header->byte_order != ITEM_FILE_BYTE_ORDER) return false;
+    if (header->header_size != sizeof(ItemFileHeader) || header->entry_size != sizeof(HashEntry)) return false;
+    if (header->group_width != GROUP_WIDTH) return false;
+    if (header->hash_function >= HASH_FUNCTION_COUNT) return false;
+    if (header->probe_mode != PROBE_LINEAR && header->probe_mode != PROBE_ROBIN_HOOD) return false;
+
+    uint64_t capacity = header->capacity;
+    if (capacity < GROUP_WIDTH || (capacity & (capacity - 1)) != 0) return false;
+    if (capacity > SIZE_MAX / sizeof(HashEntry) || header->count > capacity) return false;
+
+    if (header->file_size != size) return false;
+    if (header->entries_offset % ITEM_FILE_ALIGNMENT != 0 || header->ctrl_offset % ITEM_FILE_ALIGNMENT != 0) return false;
+    if (header->entries_offset < sizeof(ItemFileHeader) || header->entries_offset > size) return false;
+    if (capacity * sizeof(HashEntry) > size - header->entries_offset) return false;
+    if (header->ctrl_offset < header->entries_offset + capacity * sizeof(HashEntry)) return false;
+    if (header->ctrl_offset > size || capacity + GROUP_WIDTH > size - header->ctrl_offset) return false;
+
+    return true;
+}
+
+/* The slots are used in place, so a file that passes the header check could
+ * still send a lookup astray. Every slot is checked once here:
+ * - a control byte is CTRL_EMPTY or a 7 bit tag, the tail mirrors the first group
+ * - an occupied slot's tag is the top of its cached hash, as hash_tag makes it
+ * - its name ends within MAX_ITEM_NAME, so strcmp stays inside the entry
+ * - its probe_distance leads back to the home bucket of its hash
+ * - the occupied slots add up to the header's count
+ * The distance totals are counted on the way and stored in place of the header's.
+ */
+static bool slots_are_valid(const ItemFileHeader* header, const uint8_t* base, ItemTable* table) {
+    const HashEntry* entries = (const HashEntry*)(base + header->entries_offset);
+    const uint8_t* ctrl = base + header->ctrl_offset;
+    size_t capacity = (size_t)header->capacity;
+    size_t mask = capacity - 1;
+
+    for (size_t i = 0; i < GROUP_WIDTH; i++) {
+        if (ctrl[capacity + i] != ctrl[i]) return false;
+    }
+
+    size_t count = 0;
+    size_t total_distance = 0;
+    uint32_t max_distance = 0;
+    for (size_t i = 0; i < capacity; i++) {
+        if (ctrl[i] == CTRL_EMPTY) continue;
+        if (ctrl[i] & CTRL_EMPTY) return false;
+
+        const HashEntry* entry = &entries[i];
+        if (ctrl[i] != (uint8_t)(entry->hash >> 25)) return false;
+        if (!memchr(entry->item.name, '\0', MAX_ITEM_NAME)) return false;
+        if (hash_table_probe_distance(entry->hash & mask, i, mask) != entry->probe_distance) return false;
+
+        count++;
+        total_distance += entry->probe_distance;
+        if (entry->probe_distance > max_distance) max_distance = entry->probe_distance;
+    }
+    if (count != header->count) return false;
+
+    table->total_distance = total_distance;
+    table->max_distance = max_distance;
+    return true;
+}
+
+static void unmap_file(MappedItemDatabase* file) {
+#ifdef _WIN32
+    if (file->base) UnmapViewOfFile(file->base);
+    if (file->mapping_handle) CloseHandle((HANDLE)file->mapping_handle);
+    if (file->file_handle && file->file_handle != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)file->file_handle);
+    file->mapping_handle = NULL;
+    file->file_handle = NULL;
+#else
+    if (file->base) munmap(file->base, file->size);
+    if (file->fd >= 0) close(file->fd);
+    file->fd = -1;
+#endif
+    file->base = NULL;
+    file->size = 0;
+}
+
+static bool map_file(MappedItemDatabase* file, const char* path) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    file->file_handle = handle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0 || (uint64_t)size.QuadPart > SIZE_MAX) return false;
+    file->size = (size_t)size.QuadPart;
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) return false;
+    file->mapping_handle = mapping;
+
+    file->base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    return file->base != NULL;
+#else
+    file->fd = open(path, O_RDONLY);
+    if (file->fd < 0) return false;
+
+    struct stat info;
+    if (fstat(file->fd, &info) != 0 || info.st_size <= 0 || (uint64_t)info.st_size > SIZE_MAX) return false;
+    file->size = (size_t)info.st_size;
+
+    // Shared and read-only, so every process mapping the file uses the same page cache pages
+    void* base = mmap(NULL, file->size, PROT_READ, MAP_SHARED, file->fd, 0);
+    if (base == MAP_FAILED) return false;
+    file->base = base;
+    return true;
+#endif
+}
+
+bool open_item_database_file(MappedItemDatabase* file, const char* path) {
+    if (!file || !path) return false;
+
+    *file = (MappedItemDatabase){0};
+#ifndef _WIN32
+    file->fd = -1;
+#endif
+
+    ItemDatabase* db = &file->db;
+    if (!map_file(file, path) || !header_is_valid((const ItemFileHeader*)file->base, file->size)
+        || !slots_are_valid((const ItemFileHeader*)file->base, file->base, &db->table)) {
+        unmap_file(file);
+        return false;
+    }
+
+    const ItemFileHeader* header = file->base;
+    uint8_t* base = file->base;
+
+    // The slots are used in place, only the bookkeeping is filled in here
+    db->table.entries = (HashEntry*)(base + header->entries_offset);
+    db->table.ctrl = base + header->ctrl_offset;
+    db->table.capacity = (size_t)header->capacity;
+    db->table.count = (size_t)header->count;
+    db->count = (size_t)header->count;
+    db->max_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    db->probe_mode = (ProbeMode)header->probe_mode;
+    db->probe_limit = DEFAULT_PROBE_LIMIT;
+    db->hash_id = (HashFunctionId)header->hash_function;
+    db->hash = get_hash_function(db->hash_id);
+    db->seed = header->seed;
+    db->old_seed = header->seed;
+    db->reseed_threshold = DEFAULT_RESEED_THRESHOLD;
+    db->read_only = true;
+
+    return true;
+}
+
+void close_item_database_file(MappedItemDatabase* file) {
+    if (!file) return;
+    free_item_database(&file->db);
+    unmap_file(file);
+}
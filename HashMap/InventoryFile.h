@@ -0,0 +1,64 @@
+#ifndef HASHMAP_INVENTORY_FILE_H
+#define HASHMAP_INVENTORY_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "Inventory.h"
+
+// On-disk ItemDatabase: the finished table written out as is, so loading it
+// is a page-in instead of one add_item per item. Everything is addressed by
+// offsets from the start of the file, nothing in it is a pointer.
+//
+// Layout, every section starts on an ITEM_FILE_ALIGNMENT boundary:
+//   ItemFileHeader
+//   HashEntry entries[capacity]
+//   uint8_t ctrl[capacity + GROUP_WIDTH]
+#define ITEM_FILE_MAGIC "ITEMDB\r\n"   // The line break catches text mode copies
+#define ITEM_FILE_VERSION 1
+#define ITEM_FILE_ALIGNMENT 64
+#define ITEM_FILE_BYTE_ORDER 0x01020304u // Reads back swapped on the other endianness
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;      // sizeof(ItemFileHeader)
+    uint32_t entry_size;       // sizeof(HashEntry), catches a changed struct
+    uint32_t group_width;
+    uint32_t hash_function;    // HashFunctionId
+    uint32_t probe_mode;       // ProbeMode
+    uint32_t reserved;
+    uint64_t seed;
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t total_distance;
+    uint64_t max_distance;
+    uint64_t entries_offset;
+    uint64_t ctrl_offset;
+    uint64_t file_size;
+} ItemFileHeader;
+
+// An ItemDatabase whose slots live in a read-only mapping of the file.
+// Several processes opening the same file share its pages.
+typedef struct {
+    ItemDatabase db;           // read_only, use find_item/find_items on it
+    void* base;
+    size_t size;
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int fd;
+#endif
+} MappedItemDatabase;
+
+// Write the table out, finishing a resize first so every item is in one table
+bool save_item_database(ItemDatabase* db, const char* path);
+
+// Map a saved table, false if the file is missing, truncated, from another
+// build or has a slot a lookup could not trust (checked once, O(capacity))
+bool open_item_database_file(MappedItemDatabase* file, const char* path);
+void close_item_database_file(MappedItemDatabase* file);
+
+#endif //HASHMAP_INVENTORY_FILE_H
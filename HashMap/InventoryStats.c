@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "InventoryStats.h"
+
+#define BAR_WIDTH 40
+
+TableHealth item_database_health(const ItemDatabase* db) {
+    TableHealth health = {0};
+    if (!db) return health;
+
+    const ItemTable* table = &db->table;
+    health.count = table->count;
+    health.capacity = table->capacity;
+    health.probes = item_database_probe_stats(db);
+    if (table->capacity == 0) return health;
+    health.load_factor = (double)table->count / (double)table->capacity;
+
+    // Start right after a free slot so no cluster is split by the wrap around
+    size_t start = 0;
+    while (start < table->capacity && table->ctrl[start] != CTRL_EMPTY) start++;
+    if (start == table->capacity) {
+        health.clusters = 1;
+        health.longest_cluster = table->capacity;
+        health.average_cluster = (double)table->capacity;
+        return health;
+    }
+
+    size_t run = 0;
+    for (size_t i = 1; i <= table->capacity; i++) {
+        size_t index = (start + i) & (table->capacity - 1);
+        if (table->ctrl[index] != CTRL_EMPTY) {
+            run++;
+            continue;
+        }
+        if (run > 0) {
+            health.clusters++;
+            if (run > health.longest_cluster) health.longest_cluster = run;
+        }
+        run = 0;
+    }
+    if (health.clusters > 0) health.average_cluster = (double)table->count / (double)health.clusters;
+
+    return health;
+}
+
+static void print_bars(FILE* out, const char* label, const size_t histogram[], size_t buckets) {
+    size_t largest = 0;
+    size_t last = 0;
+    for (size_t i = 0; i < buckets; i++) {
+        if (histogram[i] > largest) largest = histogram[i];
+        if (histogram[i] > 0) last = i;
+    }
+    if (largest == 0) return;
+
+    fprintf(out, "%s\n", label);
+    for (size_t i = 0; i <= last; i++) {
+        int width = (int)((histogram[i] * BAR_WIDTH + largest - 1) / largest);
+        fprintf(out, "  %3zu%s | %-*.*s %zu\n", i, i == buckets - 1 ? "+" : " ", BAR_WIDTH, width,
+                "########################################", histogram[i]);
+    }
+}
+
+static void print_json_array(FILE* out, const size_t values[], size_t count) {
+    fputc('[', out);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(out, i ? ",%zu" : "%zu", values[i]);
+    }
+    fputc(']', out);
+}
+
+static void dump_text(const ItemDatabase* db, const TableHealth* health, const size_t stored[], FILE* out) {
+    fprintf(out, "Items %zu in %zu slots, load %.2f\n", health->count, health->capacity, health->load_factor);
+    fprintf(out, "Clusters %zu, longest %zu, average %.1f\n",
+            health->clusters, health->longest_cluster, health->average_cluster);
+    fprintf(out, "Stored items: %.2f probes on average, %zu at most, %zu reseeds\n",
+            health->probes.average_probe_length, health->probes.max_probe_length, health->probes.reseeds);
+    print_bars(out, "Slots between each stored item and its home:", stored, LOOKUP_HISTOGRAM_BUCKETS);
+
+#ifdef ITEM_DATABASE_STATS
+    const LookupStats* stats = &db->lookup_stats;
+    if (stats->lookups > 0) {
+        fprintf(out, "Lookups %zu: %.1f%% hits, %.2f probes on average, %zu at most\n", stats->lookups,
+                100.0 * (double)stats->hits / (double)stats->lookups,
+                (double)stats->probes / (double)stats->lookups, stats->max_probes);
+    }
+    print_bars(out, "Probes per hit:", stats->hit_probes, LOOKUP_HISTOGRAM_BUCKETS);
+    print_bars(out, "Probes per miss:", stats->miss_probes, LOOKUP_HISTOGRAM_BUCKETS);
+#else
+    (void)db;
+    fprintf(out, "Lookup counters are off, build with ITEM_DATABASE_STATS\n");
+#endif
+}
+
+static void dump_json(const ItemDatabase* db, const TableHealth* health, const size_t stored[], FILE* out) {
+    fprintf(out, "{\"count\":%zu,\"capacity\":%zu,\"load_factor\":%.4f,", health->count, health->capacity,
+            health->load_factor);
+    fprintf(out, "\"clusters\":%zu,\"longest_cluster\":%zu,\"average_cluster\":%.4f,",
+            health->clusters, health->longest_cluster, health->average_cluster);
+    fprintf(out, "\"average_probe_length\":%.4f,\"max_probe_length\":%zu,\"reseeds\":%zu,",
+            health->probes.average_probe_length, health->probes.max_probe_length, health->probes.reseeds);
+    fprintf(out, "\"probe_distance_histogram\":");
+    print_json_array(out, stored, LOOKUP_HISTOGRAM_BUCKETS);
+
+#ifdef ITEM_DATABASE_STATS
+    const LookupStats* stats = &db->lookup_stats;
+    fprintf(out, ",\"lookups\":{\"total\":%zu,\"hits\":%zu,\"misses\":%zu,\"hit_ratio\":%.4f,",
+            stats->lookups, stats->hits, stats->misses,
+            stats->lookups ? (double)stats->hits / (double)stats->lookups : 0.0);
+    fprintf(out, "\"average_probes\":%.4f,\"max_probes\":%zu,\"hit_probes\":",
+            stats->lookups ? (double)stats->probes / (double)stats->lookups : 0.0, stats->max_probes);
+    print_json_array(out, stats->hit_probes, LOOKUP_HISTOGRAM_BUCKETS);
+    fprintf(out, ",\"miss_probes\":");
+    print_json_array(out, stats->miss_probes, LOOKUP_HISTOGRAM_BUCKETS);
+    fprintf(out, "}}\n");
+#else
+    (void)db;
+    fprintf(out, ",\"lookups\":null}\n");
+#endif
+}
+
+void dump_item_database_stats(const ItemDatabase* db, FILE* out, StatsFormat format) {
+    if (!db || !out) return;
+
+    TableHealth health = item_database_health(db);
+    size_t stored[LOOKUP_HISTOGRAM_BUCKETS];
+    item_database_probe_histogram(db, stored, LOOKUP_HISTOGRAM_BUCKETS);
+
+    if (format == STATS_JSON) {
+        dump_json(db, &health, stored, out);
+    } else {
+        dump_text(db, &health, stored, out);
+    }
+}
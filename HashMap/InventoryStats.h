@@ -0,0 +1,32 @@
+#ifndef HASHMAP_INVENTORY_STATS_H
+#define HASHMAP_INVENTORY_STATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "Inventory.h"
+
+// Health report for an ItemDatabase, to line up with latency graphs and to
+// size tables from data. The table shape is worked out on demand in every
+// build, the lookup counters are only there with ITEM_DATABASE_STATS.
+typedef enum {
+    STATS_TEXT,                // Summary lines and bar histograms for a terminal
+    STATS_JSON,                // One object, for scripts and dashboards
+} StatsFormat;
+
+typedef struct {
+    size_t count;
+    size_t capacity;           // Slots of the current table
+    double load_factor;
+    size_t clusters;           // Runs of occupied slots, wrapping around the end
+    size_t longest_cluster;
+    double average_cluster;
+    ProbeStats probes;         // Of the stored items, see item_database_probe_stats
+} TableHealth;
+
+// Only `table` is looked at, finish_item_database_resize first for the whole picture
+TableHealth item_database_health(const ItemDatabase* db);
+
+void dump_item_database_stats(const ItemDatabase* db, FILE* out, StatsFormat format);
+
+#endif //HASHMAP_INVENTORY_STATS_H
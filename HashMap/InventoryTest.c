@@ -0,0 +1,369 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "Inventory.h"
+#include "InventoryFile.h"
+#include "CuckooInventory.h"
+
+// ItemDatabase regression tests, run by ctest. Each test returns the
+// number of checks that failed and prints what went wrong.
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// xorshift, so the names are the same on every platform
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void random_name(char name[MAX_ITEM_NAME], uint32_t* state) {
+    uint32_t a = next_random(state);
+    uint32_t b = next_random(state);
+    snprintf(name, MAX_ITEM_NAME, "item_%08x%08x", (unsigned)a, (unsigned)b);
+}
+
+// Fill a table at the highest load factor it accepts. A reseed or a resize
+// started while the last one was still migrating used to leave the new table
+// without a free slot, and the insert then probed forever.
+static int fill_at_load(ProbeMode mode, float reseed_threshold) {
+    int failures = 0;
+    const size_t n = 50000;
+
+    ItemDatabaseOptions options = {0};
+    options.max_load_factor = 0.95f;
+    options.probe_mode = mode;
+    options.reseed_threshold = reseed_threshold;
+
+    ItemDatabase db;
+    CHECK(init_item_database_with(&db, &options));
+
+    uint32_t state = 0x12345678u;
+    char name[MAX_ITEM_NAME];
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        CHECK(add_item(&db, name, (int)i, 1));
+    }
+    CHECK(item_database_count(&db) == n);
+
+    state = 0x12345678u;
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        GameItem* item = find_item(&db, name);
+        CHECK(item && item->damage == (int)i);
+    }
+
+    free_item_database(&db);
+    return failures;
+}
+
+// Without a filter no lookup can be the filter's false positive
+static int no_filter_no_false_positives(void) {
+    int failures = 0;
+
+    ItemDatabase db;
+    CHECK(init_item_database(&db));
+    CHECK(add_item(&db, "Sword", 10, 100));
+    CHECK(find_item(&db, "Shield") == NULL);
+    CHECK(find_item(&db, "Bow") == NULL);
+    CHECK(item_database_cache_stats(&db).filter_false_positive_rate == 0.0);
+
+    free_item_database(&db);
+    return failures;
+}
+
+// A filter sized for a small table is rebuilt as the table grows, so its
+// false positive rate stays near the one asked for
+static int filter_grows_with_table(void) {
+    int failures = 0;
+    const size_t n = 50000;
+    const double rate = 0.01;
+
+    ItemDatabaseOptions options = {0};
+    options.initial_capacity = 64;
+    options.filter_false_positive_rate = rate;
+
+    ItemDatabase db;
+    CHECK(init_item_database_with(&db, &options));
+
+    uint32_t state = 0x2468ace1u;
+    char name[MAX_ITEM_NAME];
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        CHECK(add_item(&db, name, (int)i, 1));
+    }
+    CHECK(db.filter.expected_items >= n);
+
+    // Every stored name still gets through
+    state = 0x2468ace1u;
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        CHECK(find_item(&db, name) != NULL);
+    }
+
+    state = 0x13579bdfu;
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        name[0] = 'X';   // Not a name that was added
+        CHECK(find_item(&db, name) == NULL);
+    }
+    double measured = item_database_cache_stats(&db).filter_false_positive_rate;
+    CHECK(measured < rate * 3);
+
+    free_item_database(&db);
+    return failures;
+}
+
+// Write `size` bytes to path and try to map them
+static bool open_bytes(const char* path, const uint8_t* bytes, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool written = fwrite(bytes, 1, size, file) == size;
+    if (fclose(file) != 0 || !written) return false;
+
+    MappedItemDatabase mapped;
+    if (!open_item_database_file(&mapped, path)) return false;
+    close_item_database_file(&mapped);
+    return true;
+}
+
+// A saved table maps back whole, and a file whose slots were tampered with
+// is refused instead of sending lookups past an entry or the mapping
+static int mapped_file_checks_slots(void) {
+    int failures = 0;
+    const char* path = "InventoryTest.db";
+    const size_t n = 300;
+
+    ItemDatabaseOptions options = {0};
+    options.probe_mode = PROBE_ROBIN_HOOD;
+    options.max_load_factor = 0.9f;
+
+    ItemDatabase db;
+    CHECK(init_item_database_with(&db, &options));
+    uint32_t state = 0x0f1e2d3cu;
+    char name[MAX_ITEM_NAME];
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        CHECK(add_item(&db, name, (int)i, 1));
+    }
+    CHECK(save_item_database(&db, path));
+    free_item_database(&db);
+
+    MappedItemDatabase mapped;
+    CHECK(open_item_database_file(&mapped, path));
+    state = 0x0f1e2d3cu;
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        GameItem* item = find_item(&mapped.db, name);
+        CHECK(item && item->damage == (int)i);
+    }
+    close_item_database_file(&mapped);
+
+    FILE* file = fopen(path, "rb");
+    CHECK(file != NULL);
+    if (!file) return failures;
+    fseek(file, 0, SEEK_END);
+    size_t size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* saved = malloc(size);
+    uint8_t* bytes = malloc(size);
+    CHECK(saved && bytes && fread(saved, 1, size, file) == size);
+    fclose(file);
+    if (!saved || !bytes) {
+        free(saved);
+        free(bytes);
+        remove(path);
+        return failures;
+    }
+
+    ItemFileHeader header;
+    memcpy(&header, saved, sizeof(header));
+    size_t capacity = (size_t)header.capacity;
+
+    // An occupied slot away from its home bucket, past the mirrored group
+    size_t slot = capacity;
+    for (size_t i = GROUP_WIDTH; i < capacity && slot == capacity; i++) {
+        const HashEntry* entry = (const HashEntry*)(saved + header.entries_offset) + i;
+        if (saved[header.ctrl_offset + i] != CTRL_EMPTY && entry->probe_distance > 0) slot = i;
+    }
+    CHECK(slot < capacity);
+    if (slot < capacity) {
+        uint8_t* ctrl = bytes + header.ctrl_offset;
+        HashEntry* entry = (HashEntry*)(bytes + header.entries_offset) + slot;
+
+        memcpy(bytes, saved, size);
+        CHECK(open_bytes(path, bytes, size));
+
+        // Name runs into the next entry
+        memcpy(bytes, saved, size);
+        memset(entry->item.name, 'x', MAX_ITEM_NAME);
+        CHECK(!open_bytes(path, bytes, size));
+
+        // Tag that does not match the cached hash
+        memcpy(bytes, saved, size);
+        ctrl[slot] ^= 1;
+        CHECK(!open_bytes(path, bytes, size));
+
+        // Control byte that is neither free nor a tag
+        memcpy(bytes, saved, size);
+        ctrl[slot] = CTRL_EMPTY | 1;
+        CHECK(!open_bytes(path, bytes, size));
+
+        // Probe distance that points at another home bucket, or past the table
+        memcpy(bytes, saved, size);
+        entry->probe_distance -= 1;
+        CHECK(!open_bytes(path, bytes, size));
+        memcpy(bytes, saved, size);
+        entry->probe_distance = (uint32_t)capacity;
+        CHECK(!open_bytes(path, bytes, size));
+
+        // Mirrored tail out of step with the first group
+        memcpy(bytes, saved, size);
+        ctrl[capacity] ^= 1;
+        CHECK(!open_bytes(path, bytes, size));
+
+        // A slot freed without the count knowing
+        memcpy(bytes, saved, size);
+        ctrl[slot] = CTRL_EMPTY;
+        CHECK(!open_bytes(path, bytes, size));
+    }
+
+    free(saved);
+    free(bytes);
+    remove(path);
+    return failures;
+}
+
+// Each pair of blocks takes jenkins one-at-a-time from the state the
+// blocks before it leave to one shared state, starting from 0. Bit i of `n`
+// picks the block at place i, so all 16 names have the same full hash,
+// unseeded or under a seed that folds to 0.
+static void colliding_name(char name[MAX_ITEM_NAME], unsigned n) {
+    static const char* blocks[4][2] = {
+        {"HTC0", "Lac3"}, {"5ox0", "9kf3"}, {"FI60", "Fla0"}, {"sm00", "swz0"},
+    };
+    name[0] = '\0';
+    for (int i = 0; i < 4; i++) {
+        strcat(name, blocks[i][(n >> i) & 1]);
+    }
+}
+
+// Both cuckoo buckets of a name come from its hash, so only 2 buckets' worth
+// of names can share one. A seeded table picks a new seed to split them, an
+// unseeded one refuses the name instead of growing until malloc fails.
+static int cuckoo_shared_hashes(void) {
+    int failures = 0;
+    const unsigned n = 16;
+    const size_t fit = 2 * CUCKOO_BUCKET_SLOTS;
+    char name[MAX_ITEM_NAME];
+
+    ItemDatabaseOptions options = {0};
+    options.hash_function = HASH_JENKINS_OAAT;
+
+    CuckooItemDatabase db;
+    CHECK(init_cuckoo_item_database(&db, &options));
+    size_t bucket_count = db.bucket_count;
+    for (unsigned i = 0; i < n; i++) {
+        colliding_name(name, i);
+        CHECK(cuckoo_add_item(&db, name, (int)i, 1) == (i < fit));
+    }
+    CHECK(cuckoo_item_database_count(&db) == fit);
+    CHECK(db.bucket_count == bucket_count);
+    for (unsigned i = 0; i < fit; i++) {
+        colliding_name(name, i);
+        GameItem* item = cuckoo_find_item(&db, name);
+        CHECK(item && item->damage == (int)i);
+    }
+    CHECK(cuckoo_add_item(&db, "Sword", 10, 100));
+    CHECK(cuckoo_find_item(&db, "Sword") != NULL);
+    free_cuckoo_item_database(&db);
+
+    options.hash_function = HASH_JENKINS_SEEDED;
+    options.seed = 0x100000001ULL;
+    CHECK(init_cuckoo_item_database(&db, &options));
+    for (unsigned i = 0; i < n; i++) {
+        colliding_name(name, i);
+        CHECK(cuckoo_add_item(&db, name, (int)i, 1));
+    }
+    CHECK(db.reseeds > 0);
+    CHECK(cuckoo_item_database_count(&db) == n);
+    for (unsigned i = 0; i < n; i++) {
+        colliding_name(name, i);
+        GameItem* item = cuckoo_find_item(&db, name);
+        CHECK(item && item->damage == (int)i);
+    }
+    free_cuckoo_item_database(&db);
+    return failures;
+}
+
+// A full cache evicts on every add, and the hole each eviction leaves is
+// closed by shifting the rest of its chain back. Afterwards every entry still
+// in the table has to be found from its home bucket, at the distance it keeps.
+static int evictions_keep_chains(ProbeMode mode) {
+    int failures = 0;
+    const size_t n = 20000;
+
+    ItemDatabaseOptions options = {0};
+    options.max_load_factor = 0.95f;
+    options.probe_mode = mode;
+    options.memory_budget = 64 * 1024;
+
+    ItemDatabase db;
+    CHECK(init_item_database_with(&db, &options));
+
+    uint32_t state = 0x9e3779b9u;
+    char name[MAX_ITEM_NAME];
+    for (size_t i = 0; i < n; i++) {
+        random_name(name, &state);
+        CHECK(add_item(&db, name, (int)i, 1));
+    }
+
+    const ItemTable* table = &db.table;
+    size_t mask = table->capacity - 1;
+    size_t occupied = 0;
+    size_t total_distance = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->ctrl[i] == CTRL_EMPTY) continue;
+        const HashEntry* entry = &table->entries[i];
+        CHECK(hash_table_probe_distance(entry->hash & mask, i, mask) == entry->probe_distance);
+        CHECK(find_item(&db, entry->item.name) == &entry->item);
+        occupied++;
+        total_distance += entry->probe_distance;
+    }
+    CHECK(occupied == item_database_count(&db));
+    CHECK(total_distance == table->total_distance);
+
+    free_item_database(&db);
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+
+    failures += fill_at_load(PROBE_LINEAR, 0.0f);
+    failures += fill_at_load(PROBE_ROBIN_HOOD, 0.0f);
+    // A low threshold makes the monitor reseed over and over at full load
+    failures += fill_at_load(PROBE_LINEAR, 1.5f);
+    failures += fill_at_load(PROBE_ROBIN_HOOD, 1.5f);
+    failures += no_filter_no_false_positives();
+    failures += filter_grows_with_table();
+    failures += evictions_keep_chains(PROBE_LINEAR);
+    failures += evictions_keep_chains(PROBE_ROBIN_HOOD);
+    failures += mapped_file_checks_slots();
+    failures += cuckoo_shared_hashes();
+
+    if (failures) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All inventory tests passed\n");
+    return 0;
+}
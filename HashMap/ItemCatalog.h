@@ -0,0 +1,17 @@
+#ifndef HASHMAP_ITEM_CATALOG_H
+#define HASHMAP_ITEM_CATALOG_H
+
+#include <stddef.h>
+#include "Hash.h"
+#include "Inventory.h"
+
+// Items known at build time, listed in items.catalog
+// ItemCatalog.c is generated from it by PerfectHashGen: a minimal perfect hash,
+// so a lookup is one hash, one slot and one strcmp. Items added at runtime
+// still go to an ItemDatabase.
+extern const size_t catalog_item_count;
+
+// NULL when the name is not in the catalog
+const GameItem* find_catalog_item(const char* name);
+
+#endif //HASHMAP_ITEM_CATALOG_H
@@ -1,61 +1,78 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "Hash.h"
+#include "CredentialStore.h"
+#include "CredentialBatch.h"
 
-/*
- * Jenkins one-at-a-time hash function
- * Parameters:
- * - key: pointer to the input data
- * - len: length of the input data in bytes
- * Returns: 32-bit hash value
- */
+// Function to verify credentials
+bool verify_credentials(const CredentialStore* store, const char* input_username, const char* input_password){
 
-uint32_t jenkins_hash(const void* key, size_t len)
-// key: A pointer to the data to be hashed (can be any type)
-// len: The length of the data in bytes
-// The function returns a 32-bit unsigned integer
+    // Look the user up by name, then compare the hash of the password with the stored one
+    return verify_user(store, input_username, strlen(input_username),
+                       input_password, strlen(input_password)) == VERIFY_OK;
+}
 
+/*
+ * Batch mode: HashMap <credentials file> <attempts file or -> [threads]
+ * The credentials file holds username:password_hash lines, the attempts
+ * username:password lines, "-" reads the attempts from stdin.
+ */
+static int run_batch(const char* credentials_path, const char* attempts_path, unsigned threads)
 {
-    const uint8_t* data = (const uint8_t*)key;
-    // Converts the input pointer to a byte pointer
-    // This allows us to process the input data one byte at a time
-    // uint8_t ensures we're working with unsigned 8-bit integers
-
-    uint32_t hash = 0;
-    size_t i;
-
-    // Phase 1: Process each byte of input
-    for (i = 0; i < len; ++i) {
-        hash += data[i];           // Step 1: Add byte to hash
-        hash += (hash << 10);      // Step 2: Add hash shifted left by 10
-        hash ^= (hash >> 6);       // Step 3: XOR with hash shifted right by 6
+    FILE* credentials = fopen(credentials_path, "r");
+    if (!credentials) {
+        printf("Could not open %s\n", credentials_path);
+        return 1;
     }
 
-    // Phase 2: Avalanche effect - final mixing
-    hash += (hash << 3);           // Mix 1: Add hash shifted left by 3
-    hash ^= (hash >> 11);          // Mix 2: XOR with hash shifted right by 11
-    hash += (hash << 15);          // Mix 3: Add hash shifted left by 15
-
-    return hash;
-}
-
-
-// Function to verify credentials
-bool verify_credentials(const char* input_username, const char* input_password,
-                        uint32_t stored_username_hash, uint32_t stored_password_hash){
+    CredentialStore store;
+    if (!init_credential_store(&store)) {
+        fclose(credentials);
+        return 1;
+    }
+    size_t rejected = 0;
+    size_t users = load_credentials(&store, credentials, &rejected);
+    fclose(credentials);
+    fprintf(stderr, "Loaded %zu users, skipped %zu bad lines\n", users, rejected);
+
+    FILE* attempts = strcmp(attempts_path, "-") == 0 ? stdin : fopen(attempts_path, "r");
+    if (!attempts) {
+        printf("Could not open %s\n", attempts_path);
+        free_credential_store(&store);
+        return 1;
+    }
 
-    // Calculate hashes of input credentials
-    uint32_t input_username_hash = jenkins_hash(input_username, strlen(input_username));
-    uint32_t input_password_hash = jenkins_hash(input_password, strlen(input_password));
+    BatchReport report;
+    bool ok = verify_attempts(&store, attempts, threads, &report);
+    if (attempts != stdin) fclose(attempts);
+    free_credential_store(&store);
+    if (!ok) {
+        printf("Could not start the verification threads\n");
+        return 1;
+    }
 
-    // Compare the hashes
-    return (input_username_hash == stored_username_hash && input_password_hash == stored_password_hash);
+    printf("Attempts:       %zu\n", report.attempts);
+    printf("  Accepted:     %zu\n", report.accepted);
+    printf("  Bad password: %zu\n", report.wrong_password);
+    printf("  Unknown user: %zu\n", report.unknown_user);
+    printf("  Malformed:    %zu\n", report.malformed);
+    printf("Threads:        %u\n", threads);
+    printf("Throughput:     %.0f attempts/s\n", report.seconds > 0 ? (double)report.attempts / report.seconds : 0.0);
+    printf("Latency (ns):   p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n",
+           report.p50_ns, report.p90_ns, report.p99_ns, report.p999_ns, report.max_ns);
+    return 0;
 }
 
-
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc >= 3) {
+        unsigned threads = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 10) : 4;
+        return run_batch(argv[1], argv[2], threads ? threads : 1);
+    }
+
     // Store the correct credentials' hashes (this would normally be in a database)
     const char* CORRECT_USERNAME = "Erik";
     const char* CORRECT_PASSWORD = "HashMap123";
@@ -63,6 +80,13 @@ int main()
     uint32_t stored_username_hash = jenkins_hash(CORRECT_USERNAME, strlen(CORRECT_USERNAME));
     uint32_t stored_password_hash = jenkins_hash(CORRECT_PASSWORD, strlen(CORRECT_PASSWORD));
 
+    CredentialStore store;
+    if (!init_credential_store(&store)
+        || !add_user(&store, CORRECT_USERNAME, strlen(CORRECT_USERNAME), stored_password_hash)) {
+        printf("Could not set up the user table\n");
+        return 1;
+    }
+
     // Simulating login attempts
     char input_username[50];
     char input_password[50];
@@ -73,7 +97,7 @@ int main()
     scanf("%49s", input_password);
 
     // Verify the credentials
-    if (verify_credentials(input_username, input_password,stored_username_hash, stored_password_hash))
+    if (verify_credentials(&store, input_username, input_password))
     {
         printf("Login successful!\n");
     }
@@ -89,6 +113,7 @@ int main()
     printf("Stored Password Hash: %u\n", stored_password_hash);
     printf("Input Password Hash: %u\n",jenkins_hash(input_password, strlen(input_password)));
 
+    free_credential_store(&store);
     return 0;
 }
 
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include "item_list.h"
+
+/*
+ * Writes the names catalog PerfectHashGen builds item_catalog.c from
+ * Usage: catalog_names <output catalog file>
+ * One name per line in enum Item_Name order, so the index the perfect hash
+ * gives a name is its place in items[].
+ */
+
+#define ITEM_NAME(id, name, ...) name,
+static const char* const item_names[] = { ITEM_LIST(ITEM_NAME) };
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("Usage: %s <output catalog file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (!out) {
+        printf("Could not write %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "# Generated by catalog_names from item_list.h, do not edit\n");
+    for (size_t i = 0; i < sizeof(item_names) / sizeof(item_names[0]); i++) {
+        fprintf(out, "%s\n", item_names[i]);
+    }
+
+    int failed = ferror(out);
+    if (fclose(out) != 0) failed = 1;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "inventory.h"
+
+/*
+ * Compares the selectable hash functions on a key corpus
+ * Usage: hash_benchmark <corpus file> [load factor]
+ * - corpus file: one item name per line
+ * - load factor: how full each InventoryDatabase gets before measuring
+ * The corpus is split into inventories of TABLE_SIZE slots, the probe
+ * lengths of all of them are added up per hash function.
+ */
+
+#define MAX_KEY_LENGTH 256
+#define HISTOGRAM_BUCKETS 8          // Probe lengths 1..7, the last one is 8+
+#define MIN_BENCH_SECONDS 0.2
+
+static char** load_corpus(const char* path, int* count)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) return NULL;
+
+    int capacity = 1024;
+    char** keys = malloc((size_t)capacity * sizeof(char*));
+    char line[MAX_KEY_LENGTH];
+    *count = 0;
+
+    while (keys && fgets(line, sizeof(line), file)) {
+        size_t length = strcspn(line, "\r\n");
+        if (length == 0) continue;
+        line[length] = '\0';
+
+        if (*count == capacity) {
+            capacity *= 2;
+            char** grown = realloc(keys, (size_t)capacity * sizeof(char*));
+            if (!grown) break;
+            keys = grown;
+        }
+
+        keys[*count] = malloc(length + 1);
+        if (!keys[*count]) break;
+        memcpy(keys[*count], line, length + 1);
+        (*count)++;
+    }
+
+    fclose(file);
+    return keys;
+}
+
+static void bench_throughput(HashFunctionId id, char** keys, int count)
+{
+    HashFunction hash = get_hash_function(id);
+    uint64_t seed = random_hash_seed();
+    uint32_t checksum = 0;
+    double bytes = 0;
+    int rounds = 0;
+
+    clock_t start = clock();
+    do {
+        for (int i = 0; i < count; i++) {
+            size_t length = strlen(keys[i]);
+            checksum += hash(keys[i], length, seed);
+            bytes += (double)length;
+        }
+        rounds++;
+    } while ((double)(clock() - start) / CLOCKS_PER_SEC < MIN_BENCH_SECONDS);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    double hashed = (double)count * rounds;
+    printf("| %-14s | %10.1f | %10.1f | %8.1f | %08x |\n",
+           hash_function_name(id),
+           hashed / elapsed / 1e6,
+           bytes / elapsed / (1024.0 * 1024.0),
+           elapsed / hashed * 1e9,
+           checksum);
+}
+
+static void bench_probe_lengths(HashFunctionId id, char** keys, int count, int per_inventory)
+{
+    // Every possible probe length, folded into HISTOGRAM_BUCKETS when printing
+    int totals[TABLE_SIZE] = {0};
+    int items = 0;
+
+    for (int start = 0; start + per_inventory <= count; start += per_inventory) {
+        InventoryDatabase db;
+        init_inventory_database_with_hash(&db, id, 0);
+        db.reseed_threshold = FLT_MAX;   // Measure the hash as is
+
+        for (int i = start; i < start + per_inventory; i++) {
+            Item item = {0};
+            strncpy(item.name, keys[i], MAX_ITEM_NAME - 1);
+            add_item_to_inventory(&db, &item, 1);
+        }
+
+        int histogram[TABLE_SIZE];
+        inventory_probe_histogram(&db, histogram, TABLE_SIZE);
+        for (int i = 0; i < TABLE_SIZE; i++) {
+            totals[i] += histogram[i];
+        }
+        items += db.size;
+
+        free_inventory_database(&db);
+    }
+
+    if (items == 0) return;
+
+    double average = 0;
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        average += (double)(i + 1) * totals[i];
+    }
+
+    printf("| %-14s | %5.2f |", hash_function_name(id), average / items);
+    int longer = 0;
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        if (i < HISTOGRAM_BUCKETS - 1) {
+            printf(" %5.1f%%", 100.0 * totals[i] / items);
+        } else {
+            longer += totals[i];
+        }
+    }
+    printf(" %5.1f%%", 100.0 * longer / items);
+    printf(" |\n");
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("Usage: %s <corpus file> [load factor]\n", argv[0]);
+        return 1;
+    }
+
+    float load_factor = argc > 2 ? strtof(argv[2], NULL) : 0.75f;
+    int per_inventory = (int)(load_factor * TABLE_SIZE);
+    if (per_inventory < 1 || per_inventory > TABLE_SIZE) per_inventory = TABLE_SIZE * 3 / 4;
+
+    int count = 0;
+    char** keys = load_corpus(argv[1], &count);
+    if (!keys || count == 0) {
+        printf("Could not read any keys from %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("%d keys, %d per inventory of %d slots\n\n", count, per_inventory, TABLE_SIZE);
+
+    printf("+----------------+------------+------------+----------+----------+\n");
+    printf("| Hash           | Mkeys/s    | MB/s       | ns/key   | Checksum |\n");
+    printf("+----------------+------------+------------+----------+----------+\n");
+    for (int id = 0; id < HASH_FUNCTION_COUNT; id++) {
+        bench_throughput((HashFunctionId)id, keys, count);
+    }
+    printf("+----------------+------------+------------+----------+----------+\n\n");
+
+    printf("Probe lengths in InventoryDatabase (share of items found after 1..%d+ probes)\n", HISTOGRAM_BUCKETS);
+    printf("| Hash           | Avg   |");
+    for (int i = 1; i <= HISTOGRAM_BUCKETS; i++) {
+        printf(" %5d%s", i, i == HISTOGRAM_BUCKETS ? "+" : " ");
+    }
+    printf(" |\n");
+    for (int id = 0; id < HASH_FUNCTION_COUNT; id++) {
+        bench_probe_lengths((HashFunctionId)id, keys, count, per_inventory);
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(keys[i]);
+    }
+    free(keys);
+    return 0;
+}
@@ -3,59 +3,362 @@
 #include <stdio.h>
 #include "inventory.h"
 
-uint32_t jenkins_hash(const char* item_name)
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+// Hash a name with this inventory's hash function and seed
+static uint32_t hash_name(const InventoryDatabase* db, const char* name)
 {
-    uint32_t hash = 0;
+    return db->hash(name, strlen(name), db->seed);
+}
+
+// Orders of the sort indexes: the compare_by_ order, ties broken by insertion
+// order so every node has one place
+static int order_by_insertion(const InventoryNode* a, const InventoryNode* b)
+{
+    return (a->insertion_order > b->insertion_order) - (a->insertion_order < b->insertion_order);
+}
+
+static int order_by_value(const InventoryNode* a, const InventoryNode* b)
+{
+    if (a->item.value != b->item.value) return a->item.value > b->item.value ? -1 : 1;
+    return order_by_insertion(a, b);
+}
+
+static int order_by_rarity(const InventoryNode* a, const InventoryNode* b)
+{
+    if (a->item.rarity != b->item.rarity) return a->item.rarity > b->item.rarity ? -1 : 1;
+    return order_by_insertion(a, b);
+}
+
+static int order_by_weight(const InventoryNode* a, const InventoryNode* b)
+{
+    if (a->item.weight != b->item.weight) return a->item.weight > b->item.weight ? -1 : 1;
+    return order_by_insertion(a, b);
+}
+
+static int order_by_quantity(const InventoryNode* a, const InventoryNode* b)
+{
+    if (a->quantity != b->quantity) return a->quantity > b->quantity ? -1 : 1;
+    return order_by_insertion(a, b);
+}
+
+static const SortIndexCompare index_orders[SORT_CRITERIA] = {
+    [SORT_BY_VALUE] = order_by_value,
+    [SORT_BY_RARITY] = order_by_rarity,
+    [SORT_BY_WEIGHT] = order_by_weight,
+    [SORT_BY_QUANTITY] = order_by_quantity,
+    [SORT_BY_INSERTION_ORDER] = order_by_insertion,
+};
 
-    while (*item_name)
-    {
-        hash += *item_name;
-        hash += (hash << 10);
-        hash ^= (hash >> 6);
-        item_name++;
+static void free_sort_indexes(InventoryDatabase* db)
+{
+    for (int c = 0; c < SORT_CRITERIA; c++) free_sort_index(&db->sort_indexes[c]);
+    db->indexed = false;
+}
+
+static void init_sort_indexes(InventoryDatabase* db)
+{
+    db->indexed = true;
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        db->sort_indexes[c] = (SortIndex){0};
+        if (!init_sort_index(&db->sort_indexes[c], index_orders[c])) db->indexed = false;
     }
+    if (!db->indexed) free_sort_indexes(db);
+}
+
+// Add a new node to every index, or to none if memory runs out
+static bool index_node(InventoryDatabase* db, InventoryNode* node)
+{
+    if (!db->indexed) return true;
+
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        if (sort_index_insert(&db->sort_indexes[c], node)) continue;
 
-    hash += (hash << 3);
-    hash ^= (hash >> 11);
-    hash += (hash << 15);
+        while (c-- > 0) sort_index_remove(&db->sort_indexes[c], node);
+        return false;
+    }
+    return true;
+}
 
-    return hash;
+static void unindex_node(InventoryDatabase* db, const InventoryNode* node)
+{
+    if (!db->indexed) return;
+    for (int c = 0; c < SORT_CRITERIA; c++) sort_index_remove(&db->sort_indexes[c], node);
 }
 
-void init_inventory_database(InventoryDatabase* db)
+// Quantity is the one sort key that changes, move the node's entry in that index
+static void change_quantity(InventoryDatabase* db, InventoryNode* node, int quantity)
+{
+    SortIndexEntry* entry = NULL;
+    if (db->indexed) entry = sort_index_detach(&db->sort_indexes[SORT_BY_QUANTITY], node);
+
+    node->quantity = quantity;
+    if (entry) sort_index_attach(&db->sort_indexes[SORT_BY_QUANTITY], entry);
+}
+
+void init_inventory_database_with_hash(InventoryDatabase* db, HashFunctionId hash_function, uint64_t seed)
 {
     if (!db) return;
 
-    // Initialize hash table
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        db->entries[i].is_occupied = false;
-        db->entries[i].node = NULL;
+    db->hash_id = hash_function;
+    db->hash = get_hash_function(hash_function);
+    db->seed = seed;
+    if (hash_function_is_seeded(hash_function) && seed == 0) {
+        db->seed = random_hash_seed();
     }
+    db->reseed_threshold = RESEED_THRESHOLD;
+    db->reseed_floor = 0;
+    db->reseeds = 0;
+    db->filter = (BloomFilter){0};
+#ifdef INVENTORY_STATS
+    db->lookup_stats = (InventoryLookupStats){0};
+#endif
+
+    // Initialize hash table, a failed allocation is retried by the first add
+    NodeTable_init(&db->table, TABLE_SIZE, db->seed);
 
     // Initialize linked list
     db->head = NULL;
     db->tail = NULL;
     db->size = 0;
     db->current_sort = SORT_BY_INSERTION_ORDER;
+    init_sort_indexes(db);
+}
+
+void init_inventory_database(InventoryDatabase* db)
+{
+    // Item names come from players, a random seed keeps them from
+    // picking names that all share one probe chain
+    init_inventory_database_with_hash(db, HASH_JENKINS_SEEDED, 0);
+}
+
+void free_inventory_database(InventoryDatabase* db)
+{
+    if (!db) return;
+
+    InventoryNode* current = db->head;
+    while (current != NULL) {
+        InventoryNode* next = current->next;
+        free(current);
+        current = next;
+    }
+    NodeTable_free(&db->table);
+    free_sort_indexes(db);
+    db->head = NULL;
+    db->tail = NULL;
+    db->size = 0;
+    free_bloom_filter(&db->filter);
 }
 
-InventoryNode* find_item(const InventoryDatabase* db, const char* name)
+// Put a Bloom filter in front of the table, so names that were never added
+// are turned away without probing. Removed names keep their bits and only
+// cost a probe, like any other false positive.
+bool enable_inventory_filter(InventoryDatabase* db, int expected_items, double false_positive_rate)
+{
+    if (!db || expected_items < 0) return false;
+
+    free_bloom_filter(&db->filter);
+    if (!init_bloom_filter(&db->filter, (size_t)expected_items, false_positive_rate)) return false;
+
+    for (InventoryNode* node = db->head; node != NULL; node = node->next) {
+        bloom_filter_add(&db->filter, node->item.name, strlen(node->item.name));
+    }
+    return true;
+}
+
+// Keep a sort index per criterion from now on, built from the nodes already
+// there. False, and the inventory left without indexes, if memory runs out.
+bool enable_inventory_indexes(InventoryDatabase* db)
+{
+    if (!db) return false;
+    if (db->indexed) return true;
+
+    init_sort_indexes(db);
+    for (InventoryNode* node = db->head; node != NULL && db->indexed; node = node->next) {
+        if (!index_node(db, node)) free_sort_indexes(db);
+    }
+    return db->indexed;
+}
+
+// Drop the indexes, adds and removes get cheaper and sort_inventory sorts
+// with key_sort_nodes instead
+void disable_inventory_indexes(InventoryDatabase* db)
+{
+    if (db) free_sort_indexes(db);
+}
+
+// Lookups leave the items alone, but the filter counts its checks, which is
+// why find_item and find_items take a non-const inventory
+static bool filter_may_contain(InventoryDatabase* db, const char* name)
+{
+    return bloom_filter_may_contain(&db->filter, name, strlen(name));
+}
+
+static void filter_missed(InventoryDatabase* db)
+{
+    bloom_filter_report_false_positive(&db->filter);
+}
+
+// Instrumented builds only, compiles to nothing otherwise. Walks the chain
+// of `name` again to count its probes, a NULL name is a filter rejection.
+static void count_lookup(InventoryDatabase* db, const char* name, uint32_t hash, bool hit)
+{
+#ifdef INVENTORY_STATS
+    int probes = 0;
+    const NodeTable* table = &db->table;
+    if (name && table->entries) {
+        size_t mask = table->capacity - 1;
+        size_t index = hash & mask;
+        while (probes < (int)table->capacity) {
+            probes++;
+            if (table->ctrl[index] == HASH_TABLE_EMPTY) break;
+            if (table->entries[index].hash == hash && strcmp(table->entries[index].key, name) == 0) break;
+            index = (index + 1) & mask;
+        }
+    }
+
+    InventoryLookupStats* stats = &db->lookup_stats;
+    int bucket = probes < TABLE_SIZE ? probes : TABLE_SIZE;
+    stats->lookups++;
+    stats->probes += probes;
+    if (probes > stats->max_probes) stats->max_probes = probes;
+    if (hit) {
+        stats->hits++;
+        stats->hit_probes[bucket]++;
+    } else {
+        stats->misses++;
+        stats->miss_probes[bucket]++;
+    }
+#else
+    (void)db;
+    (void)name;
+    (void)hash;
+    (void)hit;
+#endif
+}
+
+InventoryNode* find_item(InventoryDatabase* db, const char* name)
 {
     if (!db || !name) return NULL;
+    if (!filter_may_contain(db, name)) {
+        count_lookup(db, NULL, 0, false);
+        return NULL;
+    }
+
+    uint32_t hash = hash_name(db, name);
+    NodeTableEntry* entry = NodeTable_find_hashed(&db->table, name, hash);
+    if (!entry) filter_missed(db);
+    count_lookup(db, name, hash, entry != NULL);
+    return entry ? entry->value : NULL;
+}
 
-    uint32_t hash = jenkins_hash(name);
-    int index = hash % TABLE_SIZE;
-    int original_index = index;
+// Batched find_item: hash a window of names and prefetch their home slots
+// before probing any of them, so independent cache misses overlap.
+// Names the filter rules out are neither prefetched nor probed.
+// out[i] is NULL for names that are missing, returns the number found.
+int find_items(InventoryDatabase* db, const char* const names[], int n, InventoryNode* out[])
+{
+    if (!db || !names || !out) return 0;
 
-    while (db->entries[index].is_occupied) {
-        if (strcmp(db->entries[index].name, name) == 0) {
-            return db->entries[index].node;
+    int found = 0;
+
+    for (int start = 0; start < n; start += BATCH_WINDOW) {
+        int window = n - start < BATCH_WINDOW ? n - start : BATCH_WINDOW;
+        bool maybe[BATCH_WINDOW];
+
+        // Hash every key first and request its home slot
+        const void* keys[BATCH_WINDOW];
+        size_t lens[BATCH_WINDOW];
+        uint32_t hashes[BATCH_WINDOW];
+        for (int i = 0; i < window; i++) {
+            keys[i] = names[start + i];
+            lens[i] = strlen(names[start + i]);
+        }
+        if (db->hash_id == HASH_JENKINS_OAAT || db->hash_id == HASH_JENKINS_SEEDED) {
+            uint64_t seed = db->hash_id == HASH_JENKINS_SEEDED ? db->seed : 0;
+            jenkins_hash_batch_seeded(keys, lens, (size_t)window, seed, hashes);
+        } else {
+            for (int i = 0; i < window; i++) {
+                hashes[i] = db->hash(keys[i], lens[i], db->seed);
+            }
+        }
+        for (int i = 0; i < window; i++) {
+            maybe[i] = filter_may_contain(db, names[start + i]);
+            if (maybe[i] && db->table.entries) {
+                size_t home = NodeTable_home(&db->table, hashes[i]);
+                PREFETCH(&db->table.ctrl[home]);
+                PREFETCH(&db->table.entries[home]);
+            }
+        }
+
+        // Probe, prefetching the node of each hit before the next key is handled
+        for (int i = 0; i < window; i++) {
+            const char* name = names[start + i];
+            InventoryNode* node = NULL;
+
+            if (maybe[i]) {
+                NodeTableEntry* entry = NodeTable_find_hashed(&db->table, name, hashes[i]);
+                if (entry) {
+                    node = entry->value;
+                    PREFETCH(node);
+                } else {
+                    filter_missed(db);
+                }
+            }
+
+            count_lookup(db, maybe[i] ? name : NULL, hashes[i], node != NULL);
+            out[start + i] = node;
+            if (node) found++;
         }
-        index = (index + 1) % TABLE_SIZE;
-        if (index == original_index) break;
     }
 
-    return NULL;
+    return found;
+}
+
+// Put every node of the list back into an empty table, after a reseed
+static void rebuild_table(InventoryDatabase* db)
+{
+    NodeTable_clear(&db->table);
+    db->table.seed = db->seed;
+
+    for (InventoryNode* node = db->head; node != NULL; node = node->next) {
+        NodeTable_insert_hashed(&db->table, node->item.name, node, hash_name(db, node->item.name), NULL);
+    }
+}
+
+// Collision monitor: names that pile up in one chain under the current seed
+// are spread out again under a fresh one. Names that collide under every
+// seed would then rebuild the table on each insert, so after a reseed the
+// size has to double before trying again.
+static void check_probe_lengths(InventoryDatabase* db)
+{
+    if (!hash_function_is_seeded(db->hash_id)) return;
+    if (db->size <= db->reseed_floor || (size_t)db->size * 4 > db->table.capacity * 3) return;
+
+    // The scan reads every slot, so once the table has grown it only runs
+    // every capacity / TABLE_SIZE adds, about TABLE_SIZE slots per add
+    size_t interval = db->table.capacity / TABLE_SIZE;
+    if (interval > 1 && (size_t)db->size % interval != 0) return;
+
+    size_t total = 0;
+    int occupied = 0;
+    for (size_t i = 0; i < db->table.capacity; i++) {
+        if (db->table.ctrl[i] == HASH_TABLE_EMPTY) continue;
+
+        total += NodeTable_probe_distance(&db->table, i) + 1;
+        occupied++;
+    }
+
+    if (occupied == 0 || (float)total / (float)occupied <= db->reseed_threshold) return;
+
+    db->seed = random_hash_seed();
+    rebuild_table(db);
+    db->reseed_floor = db->size * 2;
+    db->reseeds++;
 }
 
 bool add_item_to_inventory(InventoryDatabase* db, const Item* item, int quantity) {
@@ -66,7 +369,7 @@ bool add_item_to_inventory(InventoryDatabase* db, const Item* item, int quantity
     // Try to find existing item using hash table
     InventoryNode* existing_node = find_item(db, item->name);
     if (existing_node) {
-        existing_node->quantity += quantity;
+        change_quantity(db, existing_node, existing_node->quantity + quantity);
         return true;
     }
 
@@ -74,14 +377,26 @@ bool add_item_to_inventory(InventoryDatabase* db, const Item* item, int quantity
     InventoryNode* new_node = (InventoryNode*)malloc(sizeof(InventoryNode));
     if (!new_node) return false;
 
-    strncpy(new_node->name, item->name, MAX_ITEM_NAME - 1);
-    new_node->name[MAX_ITEM_NAME - 1] = '\0';
     new_node->item = *item;
+    new_node->item.name[MAX_ITEM_NAME - 1] = '\0';
     new_node->quantity = quantity;
     new_node->insertion_order = insertion_counter++;
     new_node->next = NULL;
     new_node->prev = NULL;
 
+    // Add to hash table, the key is the node's own copy of the name
+    uint32_t hash = hash_name(db, new_node->item.name);
+    if (!NodeTable_insert_hashed(&db->table, new_node->item.name, new_node, hash, NULL)) {
+        free(new_node);
+        return false;
+    }
+    if (!index_node(db, new_node)) {
+        NodeTable_remove_entry(&db->table, NodeTable_find_hashed(&db->table, new_node->item.name, hash));
+        free(new_node);
+        return false;
+    }
+    bloom_filter_add(&db->filter, new_node->item.name, strlen(new_node->item.name));
+
     // Add to linked list
     if (db->head == NULL) {
         db->head = new_node;
@@ -92,26 +407,8 @@ bool add_item_to_inventory(InventoryDatabase* db, const Item* item, int quantity
         db->tail = new_node;
     }
 
-    // Add to hash table
-    uint32_t hash = jenkins_hash(item->name);
-    int index = hash % TABLE_SIZE;
-    int original_index = index;
-
-    while (db->entries[index].is_occupied) {
-        index = (index + 1) % TABLE_SIZE;
-        if (index == original_index) {
-            // Hash table is full
-            free(new_node);
-            return false;
-        }
-    }
-
-    strncpy(db->entries[index].name, item->name, MAX_ITEM_NAME - 1);
-    db->entries[index].name[MAX_ITEM_NAME - 1] = '\0';
-    db->entries[index].node = new_node;
-    db->entries[index].is_occupied = true;
-
     db->size++;
+    check_probe_lengths(db);
     return true;
 }
 
@@ -120,47 +417,120 @@ bool remove_item_from_inventory(InventoryDatabase* db, const char* name, int qua
     if (!db || !name || quantity <= 0) return false;
 
     // Find item using hash table
-    uint32_t hash = jenkins_hash(name);
-    int index = hash % TABLE_SIZE;
-    int original_index = index;
-
-    while (db->entries[index].is_occupied) {
-        if (strcmp(db->entries[index].name, name) == 0) {
-            InventoryNode* node = db->entries[index].node;
-
-            if (node->quantity >= quantity) {
-                node->quantity -= quantity;
-
-                // Remove node if quantity becomes 0
-                if (node->quantity == 0) {
-                    // Update linked list
-                    if (node->prev) {
-                        node->prev->next = node->next;
-                    } else {
-                        db->head = node->next;
-                    }
-
-                    if (node->next) {
-                        node->next->prev = node->prev;
-                    } else {
-                        db->tail = node->prev;
-                    }
-
-                    // Update hash table
-                    db->entries[index].is_occupied = false;
-                    db->entries[index].node = NULL;
-
-                    free(node);
-                    db->size--;
-                }
-                return true;
-            }
-            return false;
+    NodeTableEntry* entry = NodeTable_find_hashed(&db->table, name, hash_name(db, name));
+    if (!entry) return false;
+
+    InventoryNode* node = entry->value;
+    if (node->quantity < quantity) return false;
+
+    if (node->quantity > quantity) {
+        change_quantity(db, node, node->quantity - quantity);
+    } else {
+        // Quantity becomes 0, remove the node
+        unindex_node(db, node);
+
+        // Update linked list
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            db->head = node->next;
+        }
+
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            db->tail = node->prev;
         }
-        index = (index + 1) % TABLE_SIZE;
-        if (index == original_index) break;
+
+        // Update hash table, the rest of the chain shifts back so later names stay reachable
+        NodeTable_remove_entry(&db->table, entry);
+
+        free(node);
+        db->size--;
+    }
+    return true;
+}
+
+// Count entries by probe length: histogram[i] gets the items a lookup finds
+// after i + 1 probes, the last bucket also takes everything longer
+void inventory_probe_histogram(const InventoryDatabase* db, int histogram[], int buckets)
+{
+    if (!db || !histogram || buckets <= 0) return;
+
+    memset(histogram, 0, (size_t)buckets * sizeof(int));
+
+    for (size_t i = 0; i < db->table.capacity; i++) {
+        if (db->table.ctrl[i] == HASH_TABLE_EMPTY) continue;
+
+        size_t distance = NodeTable_probe_distance(&db->table, i);
+        histogram[distance < (size_t)buckets ? distance : (size_t)buckets - 1]++;
     }
-    return false;
+}
+
+// Table shape plus, in INVENTORY_STATS builds, the lookup counters:
+// a few summary lines and bar charts, or one JSON object
+void dump_inventory_stats(const InventoryDatabase* db, FILE* out, bool json)
+{
+    if (!db || !out) return;
+
+    int distances[TABLE_SIZE];
+    inventory_probe_histogram(db, distances, TABLE_SIZE);
+
+    // Longest run of occupied slots, wrapping around the end
+    int capacity = (int)db->table.capacity;
+    int run = 0;
+    int longest_cluster = 0;
+    for (int i = 0; i < 2 * capacity; i++) {
+        bool used = db->table.ctrl[i % capacity] != HASH_TABLE_EMPTY;
+        run = used ? run + 1 : 0;
+        if (run > longest_cluster) longest_cluster = run;
+    }
+    if (longest_cluster > capacity) longest_cluster = capacity;
+    double load_factor = capacity ? (double)db->table.count / capacity : 0.0;
+
+    if (json) {
+        fprintf(out, "{\"size\":%d,\"capacity\":%d,\"load_factor\":%.4f,\"longest_cluster\":%d,\"reseeds\":%d,",
+                db->size, capacity, load_factor, longest_cluster, db->reseeds);
+        fprintf(out, "\"probe_distance_histogram\":[");
+        for (int i = 0; i < TABLE_SIZE; i++) fprintf(out, i ? ",%d" : "%d", distances[i]);
+        fprintf(out, "]");
+#ifdef INVENTORY_STATS
+        const InventoryLookupStats* stats = &db->lookup_stats;
+        fprintf(out, ",\"lookups\":{\"total\":%d,\"hits\":%d,\"misses\":%d,\"hit_ratio\":%.4f,",
+                stats->lookups, stats->hits, stats->misses,
+                stats->lookups ? (double)stats->hits / stats->lookups : 0.0);
+        fprintf(out, "\"average_probes\":%.4f,\"max_probes\":%d,\"hit_probes\":[",
+                stats->lookups ? (double)stats->probes / stats->lookups : 0.0, stats->max_probes);
+        for (int i = 0; i <= TABLE_SIZE; i++) fprintf(out, i ? ",%d" : "%d", stats->hit_probes[i]);
+        fprintf(out, "],\"miss_probes\":[");
+        for (int i = 0; i <= TABLE_SIZE; i++) fprintf(out, i ? ",%d" : "%d", stats->miss_probes[i]);
+        fprintf(out, "]}}\n");
+#else
+        fprintf(out, ",\"lookups\":null}\n");
+#endif
+        return;
+    }
+
+    fprintf(out, "Items %d in %d slots, load %.2f, longest cluster %d, %d reseeds\n",
+            db->size, capacity, load_factor, longest_cluster, db->reseeds);
+    fprintf(out, "Slots between each item and its home:\n");
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        if (distances[i] == 0) continue;
+        fprintf(out, "  %2d | %.*s %d\n", i, distances[i] < 16 ? distances[i] : 16, "################", distances[i]);
+    }
+#ifdef INVENTORY_STATS
+    const InventoryLookupStats* stats = &db->lookup_stats;
+    if (stats->lookups == 0) return;
+    fprintf(out, "Lookups %d: %.1f%% hits, %.2f probes on average, %d at most\n", stats->lookups,
+            100.0 * stats->hits / stats->lookups, (double)stats->probes / stats->lookups, stats->max_probes);
+    fprintf(out, "Probes | hits | misses\n");
+    for (int i = 0; i <= TABLE_SIZE; i++) {
+        if (stats->hit_probes[i] == 0 && stats->miss_probes[i] == 0) continue;
+        fprintf(out, "  %4d | %4d | %6d\n", i, stats->hit_probes[i], stats->miss_probes[i]);
+    }
+#else
+    fprintf(out, "Lookup counters are off, build with INVENTORY_STATS\n");
+#endif
 }
 
 int compare_by_value(const InventoryNode* a, const InventoryNode* b) {
@@ -177,7 +547,8 @@ int compare_by_rarity(const InventoryNode* a, const InventoryNode* b) {
 }
 
 int compare_by_weight(const InventoryNode* a, const InventoryNode* b) {
-    return b->item.weight - a->item.weight;
+    // Not the difference: as an int it would call weights less than 1 apart equal
+    return (a->item.weight < b->item.weight) - (a->item.weight > b->item.weight);
 }
 
 int compare_by_quantity(const InventoryNode* a, const InventoryNode* b) {
@@ -188,9 +559,47 @@ int compare_by_insertion_order(const InventoryNode* a, const InventoryNode* b) {
     return a->insertion_order - b->insertion_order;
 }
 
+// The compare_by_ function each index stands in for
+static const CompareFunction criterion_compares[SORT_CRITERIA] = {
+    [SORT_BY_VALUE] = compare_by_value,
+    [SORT_BY_RARITY] = compare_by_rarity,
+    [SORT_BY_WEIGHT] = compare_by_weight,
+    [SORT_BY_QUANTITY] = compare_by_quantity,
+    [SORT_BY_INSERTION_ORDER] = compare_by_insertion_order,
+};
+
+// Make the list the order of an index, one pass over it
+static void relink_from_index(InventoryDatabase* db, SortCriterion criterion)
+{
+    InventoryNode* prev = NULL;
+    for (SortIndexEntry* entry = sort_index_first(&db->sort_indexes[criterion]); entry; entry = entry->next[0]) {
+        InventoryNode* node = entry->node;
+        node->prev = prev;
+        if (prev) prev->next = node; else db->head = node;
+        prev = node;
+    }
+    if (prev) prev->next = NULL;
+    db->tail = prev;
+    db->current_sort = criterion;
+}
+
 void sort_inventory(InventoryDatabase* db, CompareFunction compare_func) {
     if (!db || !compare_func || db->size <= 1) return;
 
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        if (compare_func != criterion_compares[c]) continue;
+
+        if (db->indexed) {
+            relink_from_index(db, (SortCriterion)c);
+            return;
+        }
+        if (key_sort_nodes(db, (SortCriterion)c)) {
+            db->current_sort = (SortCriterion)c;
+            return;
+        }
+        break;
+    }
+
     if (compare_func == compare_by_insertion_order) {
         bubble_sort_nodes(db, compare_func);
         db->current_sort = SORT_BY_INSERTION_ORDER;
@@ -216,73 +625,146 @@ void sort_inventory(InventoryDatabase* db, CompareFunction compare_func) {
         db->current_sort = SORT_BY_QUANTITY;
     }
 }
-void swap_node_data(InventoryNode* a, InventoryNode* b, InventoryDatabase* db) {
-    // Swap node data
-    Item temp_item = a->item;
-    int temp_quantity = a->quantity;
-    int temp_order = a->insertion_order;
-    char temp_name[MAX_ITEM_NAME];
-    strncpy(temp_name, a->name, MAX_ITEM_NAME - 1);
+/* Move a node one place down the list, past its next, by relinking the two.
+ * The items stay in their nodes, so the name table, which points at the
+ * nodes, stays right and a swap is a few pointer writes whatever the item holds.
+ */
+static void swap_with_next(InventoryNode* node, InventoryDatabase* db) {
+    InventoryNode* next = node->next;
+    if (!next) return;
 
-    a->item = b->item;
-    a->quantity = b->quantity;
-    a->insertion_order = b->insertion_order;
-    strncpy(a->name, b->name, MAX_ITEM_NAME - 1);
+    InventoryNode* before = node->prev;
+    InventoryNode* after = next->next;
 
-    b->item = temp_item;
-    b->quantity = temp_quantity;
-    b->insertion_order = temp_order;
-    strncpy(b->name, temp_name, MAX_ITEM_NAME - 1);
+    next->prev = before;
+    next->next = node;
+    node->prev = next;
+    node->next = after;
 
-    // Update hash table entries
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        if (db->entries[i].is_occupied) {
-            if (db->entries[i].node == a) {
-                strncpy(db->entries[i].name, a->name, MAX_ITEM_NAME - 1);
-            }
-            else if (db->entries[i].node == b) {
-                strncpy(db->entries[i].name, b->name, MAX_ITEM_NAME - 1);
-            }
-        }
+    if (before) before->next = next; else db->head = next;
+    if (after) after->prev = node; else db->tail = node;
+}
+
+// Quick sort and heap sort work on an array of the node pointers: finding
+// position i in the list means walking i nodes, and they ask for positions in
+// their inner loops. The list is gathered once, sorted as an array and relinked
+// in one pass, the nodes themselves never move so the name table stays valid.
+#define INSERTION_SORT_CUTOFF 16  // Ranges this short are insertion sorted
+
+// The list in order, NULL if it is empty or memory ran out
+static InventoryNode** gather_nodes(const InventoryDatabase* db)
+{
+    if (db->size <= 0) return NULL;
+
+    InventoryNode** nodes = malloc((size_t)db->size * sizeof(InventoryNode*));
+    if (!nodes) return NULL;
+
+    int i = 0;
+    for (InventoryNode* node = db->head; node && i < db->size; node = node->next) {
+        nodes[i++] = node;
     }
+    return nodes;
 }
 
-// Get node at position
-InventoryNode* get_node_at(InventoryNode* head, int pos) {
-    InventoryNode* current = head;
-    for (int i = 0; i < pos && current != NULL; i++) {
-        current = current->next;
+// Make nodes[0..n) the list, in that order
+static void relink_nodes(InventoryDatabase* db, InventoryNode* nodes[], int n)
+{
+    for (int i = 0; i < n; i++) {
+        nodes[i]->prev = i > 0 ? nodes[i - 1] : NULL;
+        nodes[i]->next = i + 1 < n ? nodes[i + 1] : NULL;
     }
-    return current;
+    db->head = n > 0 ? nodes[0] : NULL;
+    db->tail = n > 0 ? nodes[n - 1] : NULL;
 }
 
-// Partition function for quicksort
-int partition(InventoryDatabase* db, int low, int high, CompareFunction compare_func) {
-    InventoryNode* pivot = get_node_at(db->head, high);
-    int i = low - 1;
+static void swap_pointers(InventoryNode** a, InventoryNode** b)
+{
+    InventoryNode* temp = *a;
+    *a = *b;
+    *b = temp;
+}
 
-    for (int j = low; j < high; j++) {
-        InventoryNode* current = get_node_at(db->head, j);
-        if (compare_func(current, pivot) <= 0) {
-            i++;
-            InventoryNode* node_i = get_node_at(db->head, i);
-            swap_node_data(node_i, current, db);
+static void insertion_sort_array(InventoryNode* nodes[], int low, int high, CompareFunction compare_func)
+{
+    for (int i = low + 1; i <= high; i++) {
+        InventoryNode* node = nodes[i];
+        int j = i - 1;
+        while (j >= low && compare_func(nodes[j], node) > 0) {
+            nodes[j + 1] = nodes[j];
+            j--;
         }
+        nodes[j + 1] = node;
     }
+}
+
+// Median of the first, middle and last node, so sorted input does not
+// make every partition lopsided
+static InventoryNode* median_of_three(InventoryNode* nodes[], int low, int high, CompareFunction compare_func)
+{
+    InventoryNode* a = nodes[low];
+    InventoryNode* b = nodes[low + (high - low) / 2];
+    InventoryNode* c = nodes[high];
 
-    InventoryNode* node_i_plus_1 = get_node_at(db->head, i + 1);
-    InventoryNode* node_high = get_node_at(db->head, high);
-    swap_node_data(node_i_plus_1, node_high, db);
-    return i + 1;
+    if (compare_func(a, b) < 0) {
+        if (compare_func(b, c) < 0) return b;
+        return compare_func(a, c) < 0 ? c : a;
+    }
+    if (compare_func(a, c) < 0) return a;
+    return compare_func(b, c) < 0 ? c : b;
+}
+
+/* Three way partition around the pivot: smaller nodes to the left, equal ones
+ * in the middle, larger ones to the right. Quantities and values repeat a lot,
+ * and the equal block is never looked at again. It recurses into the smaller
+ * side and loops on the larger one, so the stack stays O(log n).
+ */
+static void quick_sort_array(InventoryNode* nodes[], int low, int high, CompareFunction compare_func)
+{
+    while (high - low >= INSERTION_SORT_CUTOFF) {
+        InventoryNode* pivot = median_of_three(nodes, low, high, compare_func);
+        int lt = low;
+        int i = low;
+        int gt = high;
+
+        while (i <= gt) {
+            int order = compare_func(nodes[i], pivot);
+            if (order < 0) {
+                swap_pointers(&nodes[lt++], &nodes[i++]);
+            } else if (order > 0) {
+                swap_pointers(&nodes[i], &nodes[gt--]);
+            } else {
+                i++;
+            }
+        }
+
+        if (lt - low < high - gt) {
+            quick_sort_array(nodes, low, lt - 1, compare_func);
+            low = gt + 1;
+        } else {
+            quick_sort_array(nodes, gt + 1, high, compare_func);
+            high = lt - 1;
+        }
+    }
+    insertion_sort_array(nodes, low, high, compare_func);
 }
 
 // Quicksort function
 void quick_sort_nodes(InventoryDatabase* db, int low, int high, CompareFunction compare_func) {
-    if (low < high) {
-        int pi = partition(db, low, high, compare_func);
-        quick_sort_nodes(db, low, pi - 1, compare_func);
-        quick_sort_nodes(db, pi + 1, high, compare_func);
+    if (!db || !compare_func) return;
+    if (low < 0) low = 0;
+    if (high > db->size - 1) high = db->size - 1;
+    if (low >= high) return;
+
+    InventoryNode** nodes = gather_nodes(db);
+    if (!nodes) {
+        // Merge sort needs no memory, but it only does whole lists
+        if (low == 0 && high == db->size - 1) merge_sort_nodes(db, &(db->head), compare_func);
+        return;
     }
+
+    quick_sort_array(nodes, low, high, compare_func);
+    relink_nodes(db, nodes, db->size);
+    free(nodes);
 }
 // Bubble sort function
 void bubble_sort_nodes(InventoryDatabase* db, CompareFunction compare_func) {
@@ -296,38 +778,12 @@ void bubble_sort_nodes(InventoryDatabase* db, CompareFunction compare_func) {
 
         while (current->next != last) {
             if (compare_func(current, current->next) > 0) {
-                // Swap node data
-                Item temp_item = current->item;
-                int temp_quantity = current->quantity;
-                int temp_order = current->insertion_order;
-                char temp_name[MAX_ITEM_NAME];
-                strncpy(temp_name, current->name, MAX_ITEM_NAME - 1);
-
-                current->item = current->next->item;
-                current->quantity = current->next->quantity;
-                current->insertion_order = current->next->insertion_order;
-                strncpy(current->name, current->next->name, MAX_ITEM_NAME - 1);
-
-                current->next->item = temp_item;
-                current->next->quantity = temp_quantity;
-                current->next->insertion_order = temp_order;
-                strncpy(current->next->name, temp_name, MAX_ITEM_NAME - 1);
-
-                // Update hash table entries
-                for (int i = 0; i < TABLE_SIZE; i++) {
-                    if (db->entries[i].is_occupied) {
-                        if (db->entries[i].node == current) {
-                            strncpy(db->entries[i].name, current->name, MAX_ITEM_NAME - 1);
-                        }
-                        else if (db->entries[i].node == current->next) {
-                            strncpy(db->entries[i].name, current->next->name, MAX_ITEM_NAME - 1);
-                        }
-                    }
-                }
-
+                // current moves one place on, it gets compared with its new next
+                swap_with_next(current, db);
                 swapped = true;
+            } else {
+                current = current->next;
             }
-            current = current->next;
         }
         last = current;
     } while (swapped);
@@ -357,31 +813,24 @@ void findMiddle(InventoryNode* head, InventoryNode** middle) {
 }
 
 void merge(InventoryNode** headRef, InventoryNode* left, InventoryNode* right,InventoryDatabase* db, CompareFunction compare_func) {
+    (void)db;
     InventoryNode* result = NULL;
-
-    // Base cases
-    if (left == NULL) {
-        *headRef = right;
-        return;
-    }
-    if (right == NULL) {
-        *headRef = left;
-        return;
-    }
-
-    // Compare nodes using the provided comparison function
-    if (compare_func(left, right) <= 0) {
-        result = left;
-        merge(&(result->next), left->next, right, db, compare_func);
-    } else {
-        result = right;
-        merge(&(result->next), left, right->next, db, compare_func);
-    }
-
-    // Update prev pointer for the next node
-    if (result->next) {
-        result->next->prev = result;
+    InventoryNode** last = &result;
+
+    // A loop, not a call per node: long lists would run out of stack.
+    // merge_sort_nodes fixes the prev pointers afterwards.
+    while (left != NULL && right != NULL) {
+        // Compare nodes using the provided comparison function
+        if (compare_func(left, right) <= 0) {
+            *last = left;
+            left = left->next;
+        } else {
+            *last = right;
+            right = right->next;
+        }
+        last = &(*last)->next;
     }
+    *last = left != NULL ? left : right;
 
     *headRef = result;
 }
@@ -431,76 +880,239 @@ void merge_sort_nodes(InventoryDatabase* db, InventoryNode** headRef, CompareFun
 }
 
 // Heap sort function
-int count_nodes(InventoryNode* head) {
-    int count = 0;
-    InventoryNode* current = head;
-    while (current != NULL) {
-        count++;
-        current = current->next;
+static void heapify(InventoryNode* nodes[], int n, int i, CompareFunction compare_func)
+{
+    for (;;) {
+        int largest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+
+        if (left < n && compare_func(nodes[left], nodes[largest]) > 0) largest = left;
+        if (right < n && compare_func(nodes[right], nodes[largest]) > 0) largest = right;
+        if (largest == i) return;
+
+        swap_pointers(&nodes[i], &nodes[largest]);
+        i = largest;
     }
-    return count;
 }
-void heapify(InventoryDatabase* db, InventoryNode* head, int n, int i,CompareFunction compare_func) {
-    int largest = i;
-    int left = 2 * i + 1;
-    int right = 2 * i + 2;
+void heap_sort_nodes(InventoryDatabase* db, InventoryNode** headRef,CompareFunction compare_func) {
+    if (!db || !headRef || !(*headRef) || !compare_func) return;
 
-    InventoryNode* largest_node = get_node_at(head, largest);
-    InventoryNode* left_node = (left < n) ? get_node_at(head, left) : NULL;
-    InventoryNode* right_node = (right < n) ? get_node_at(head, right) : NULL;
+    InventoryNode** nodes = gather_nodes(db);
+    if (!nodes) {
+        merge_sort_nodes(db, headRef, compare_func);
+        return;
+    }
+    int n = db->size;
 
-    // Compare with left child
-    if (left < n && left_node && compare_func(left_node, largest_node) > 0) {
-        largest = left;
-        largest_node = left_node;
+    // Build max heap
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        heapify(nodes, n, i, compare_func);
     }
 
-    // Compare with right child
-    if (right < n && right_node && compare_func(right_node, largest_node) > 0) {
-        largest = right;
-        largest_node = right_node;
+    // Move the root to the end, then heapify the reduced heap
+    for (int i = n - 1; i > 0; i--) {
+        swap_pointers(&nodes[0], &nodes[i]);
+        heapify(nodes, i, 0, compare_func);
     }
 
-    // If largest is not root
-    if (largest != i) {
-        InventoryNode* i_node = get_node_at(head, i);
-        swap_node_data(i_node, largest_node, db);
-        heapify(db, head, n, largest, compare_func);
+    relink_nodes(db, nodes, n);
+    free(nodes);
+}
+
+// Key sort: every node gets one integer that orders it the way its criterion
+// and then its insertion order would, so the sort compares plain integers
+// instead of calling a compare function that reads both nodes.
+typedef struct {
+    uint64_t key;
+    InventoryNode* node;
+} SortKey;
+
+// Unsigned numbers that sort the way the signed or float ones do
+static uint32_t ordered_int(int x)
+{
+    return (uint32_t)x ^ 0x80000000u;
+}
+
+static uint32_t ordered_float(float x)
+{
+    if (x == 0.0f) x = 0.0f;  // -0 and 0 compare equal
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    // Negative floats sort backwards by their bits, so flip them all
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+// Criterion in the top half, inverted where it sorts descending, insertion
+// order in the bottom half
+static uint64_t node_sort_key(const InventoryNode* node, SortCriterion criterion)
+{
+    uint32_t major = 0;
+    switch (criterion) {
+        case SORT_BY_VALUE: major = ~ordered_int(node->item.value); break;
+        case SORT_BY_RARITY: major = ~ordered_int((int)node->item.rarity); break;
+        case SORT_BY_WEIGHT: major = ~ordered_float(node->item.weight); break;
+        case SORT_BY_QUANTITY: major = ~ordered_int(node->quantity); break;
+        case SORT_BY_INSERTION_ORDER: break;
     }
+    return (uint64_t)major << 32 | ordered_int(node->insertion_order);
 }
-void heap_sort_nodes(InventoryDatabase* db, InventoryNode** headRef,CompareFunction compare_func) {
-    if (!db || !headRef || !(*headRef)) return;
 
-    int n = count_nodes(*headRef);
+static void swap_keys(SortKey* a, SortKey* b)
+{
+    SortKey temp = *a;
+    *a = *b;
+    *b = temp;
+}
 
-    // Build max heap
-    for (int i = n / 2 - 1; i >= 0; i--) {
-        heapify(db, *headRef, n, i, compare_func);
+static void insertion_sort_keys(SortKey keys[], int low, int high)
+{
+    for (int i = low + 1; i <= high; i++) {
+        SortKey key = keys[i];
+        int j = i - 1;
+        while (j >= low && keys[j].key > key.key) {
+            keys[j + 1] = keys[j];
+            j--;
+        }
+        keys[j + 1] = key;
     }
+}
 
-    // Extract elements from heap one by one
-    for (int i = n - 1; i >= 0; i--) {
-        // Move current root to end
-        InventoryNode* last_node = get_node_at(*headRef, i);
-        InventoryNode* root_node = *headRef;
+// The keys are all different, insertion order sees to that, so a two way
+// partition is enough here
+static void quick_sort_keys(SortKey keys[], int low, int high)
+{
+    while (high - low >= INSERTION_SORT_CUTOFF) {
+        int mid = low + (high - low) / 2;
+        if (keys[mid].key < keys[low].key) swap_keys(&keys[mid], &keys[low]);
+        if (keys[high].key < keys[low].key) swap_keys(&keys[high], &keys[low]);
+        if (keys[high].key < keys[mid].key) swap_keys(&keys[high], &keys[mid]);
+        uint64_t pivot = keys[mid].key;
+
+        int i = low;
+        int j = high;
+        while (i <= j) {
+            while (keys[i].key < pivot) i++;
+            while (keys[j].key > pivot) j--;
+            if (i <= j) swap_keys(&keys[i++], &keys[j--]);
+        }
 
-        swap_node_data(root_node, last_node, db);
+        if (j - low < high - i) {
+            quick_sort_keys(keys, low, j);
+            low = i;
+        } else {
+            quick_sort_keys(keys, i, high);
+            high = j;
+        }
+    }
+    insertion_sort_keys(keys, low, high);
+}
 
-        // Call heapify on the reduced heap
-        heapify(db, *headRef, i, 0, compare_func);
+/* Counting sort, for keys whose criterion only takes a few values: rarity is
+ * one of five, quantities are small. Both halves of the key get stable
+ * counting passes, least significant first:
+ * - insertion order a byte at a time, skipped when the keys are in insertion
+ *   order already, as a list nobody sorted is
+ * - then the criterion in one pass over its whole range, which keeps
+ *   insertion order within each value
+ * A pass whose digit is the same for every key moves nothing and is skipped.
+ */
+#define COUNTING_SORT_MAX_RANGE 1024  // Criterion values at most, for the counting sort
+
+// Stable pass over one digit of the key, (key >> shift & mask) - base.
+// False, and nothing moved, if every key has the same digit.
+static bool counting_pass(const SortKey in[], SortKey out[], int n, size_t counts[], size_t buckets,
+                          int shift, uint64_t mask, uint64_t base)
+{
+    memset(counts, 0, buckets * sizeof(size_t));
+    for (int i = 0; i < n; i++) {
+        counts[((in[i].key >> shift) & mask) - base]++;
     }
 
-    // Update prev pointers and tail
-    InventoryNode* current = *headRef;
-    InventoryNode* prev = NULL;
+    size_t start = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        if (counts[b] == (size_t)n) return false;
 
-    while (current != NULL) {
-        current->prev = prev;
-        prev = current;
-        if (current->next == NULL) {
-            db->tail = current;
+        size_t count = counts[b];
+        counts[b] = start;
+        start += count;
+    }
+
+    for (int i = 0; i < n; i++) {
+        out[counts[((in[i].key >> shift) & mask) - base]++] = in[i];
+    }
+    return true;
+}
+
+static bool counting_sort_keys(SortKey keys[], int n, uint32_t major_min, size_t major_range)
+{
+    size_t buckets = major_range > 256 ? major_range : 256;
+    SortKey* scratch = malloc((size_t)n * sizeof(SortKey));
+    size_t* counts = malloc(buckets * sizeof(size_t));
+    if (!scratch || !counts) {
+        free(scratch);
+        free(counts);
+        return false;
+    }
+
+    SortKey* from = keys;
+    SortKey* to = scratch;
+    SortKey* temp;
+
+    bool in_insertion_order = true;
+    for (int i = 1; i < n && in_insertion_order; i++) {
+        in_insertion_order = (uint32_t)keys[i - 1].key < (uint32_t)keys[i].key;
+    }
+    if (!in_insertion_order) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            if (!counting_pass(from, to, n, counts, 256, shift, 0xFF, 0)) continue;
+            temp = from; from = to; to = temp;
         }
-        current = current->next;
     }
+
+    if (counting_pass(from, to, n, counts, major_range, 32, 0xFFFFFFFF, major_min)) {
+        temp = from; from = to; to = temp;
+    }
+
+    if (from != keys) memcpy(keys, from, (size_t)n * sizeof(SortKey));
+    free(scratch);
+    free(counts);
+    return true;
 }
 
+bool key_sort_nodes(InventoryDatabase* db, SortCriterion criterion)
+{
+    if (!db || criterion < 0 || criterion >= SORT_CRITERIA) return false;
+    if (db->size <= 1) return true;
+
+    SortKey* keys = malloc((size_t)db->size * sizeof(SortKey));
+    if (!keys) return false;
+
+    int n = 0;
+    uint32_t major_min = UINT32_MAX;
+    uint32_t major_max = 0;
+    for (InventoryNode* node = db->head; node && n < db->size; node = node->next) {
+        keys[n].key = node_sort_key(node, criterion);
+        keys[n].node = node;
+
+        uint32_t major = (uint32_t)(keys[n].key >> 32);
+        if (major < major_min) major_min = major;
+        if (major > major_max) major_max = major;
+        n++;
+    }
+
+    // Weights are floats, a small range of their bits says nothing useful
+    bool counted = criterion != SORT_BY_WEIGHT && major_max - major_min < COUNTING_SORT_MAX_RANGE &&
+                   counting_sort_keys(keys, n, major_min, (size_t)(major_max - major_min) + 1);
+    if (!counted) quick_sort_keys(keys, 0, n - 1);
+
+    for (int i = 0; i < n; i++) {
+        keys[i].node->prev = i > 0 ? keys[i - 1].node : NULL;
+        keys[i].node->next = i + 1 < n ? keys[i + 1].node : NULL;
+    }
+    db->head = keys[0].node;
+    db->tail = keys[n - 1].node;
+
+    free(keys);
+    return true;
+}
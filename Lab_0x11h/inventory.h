@@ -1,11 +1,19 @@
 #ifndef LAB_0X11H_INVENTORY_H
 #define LAB_0X11H_INVENTORY_H
 
+#include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "item.h"
+#include "Hash.h"
+#include "BloomFilter.h"
+#include "HashTable.h"
+#include "sort_index.h"
 
-#define TABLE_SIZE 16
+#define TABLE_SIZE 16     // Starting slots of the name table, and the slots drawn by the UI
+#define BATCH_WINDOW 16  // Keys in flight at once in find_items
+#define RESEED_THRESHOLD 3.0f  // Average probe length that makes the table pick a new seed
 
 // Window configuration
 #define WINDOW_WIDTH 1280
@@ -22,40 +30,80 @@ typedef enum {
     SORT_BY_QUANTITY,
     SORT_BY_INSERTION_ORDER,
 } SortCriterion;
+#define SORT_CRITERIA (SORT_BY_INSERTION_ORDER + 1)
 
 typedef struct InventoryNode {
-    char name[MAX_ITEM_NAME];
-    Item item;
+    Item item;                       // item.name is the key
     int quantity;
     int insertion_order;
     struct InventoryNode* next;
     struct InventoryNode* prev;
 } InventoryNode;
 
+// Name table: the key points at node->item.name, so the name is kept once,
+// and the slot caches its hash so probes skip other names without following
+// the pointer. inventory.c hashes names itself with the inventory's chosen
+// function and uses the _hashed calls, NodeTable_find and NodeTable_insert
+// would hash with the seeded Jenkins default.
+#define NODE_NAME_HASH(name, seed) jenkins_hash_seeded(name, strlen(name), seed)
+#define NODE_NAME_EQUALS(a, b) (strcmp(a, b) == 0)
+DEFINE_HASH_TABLE(NodeTable, const char*, InventoryNode*, NODE_NAME_HASH, NODE_NAME_EQUALS)
+
+// Per lookup counters, compiled in with INVENTORY_STATS defined
+// (cmake -DINVENTORY_STATS=ON). A probe is one slot looked at, a miss
+// counts the free slot that ended it and a filter rejection counts 0.
+// add_item_to_inventory looks its name up first, so adds are counted too.
 typedef struct {
-    char name[MAX_ITEM_NAME];
-    InventoryNode* node;
-    bool is_occupied;
-} HashEntry;
+    int lookups;
+    int hits;
+    int misses;
+    int probes;                      // Over all lookups
+    int max_probes;
+    int hit_probes[TABLE_SIZE + 1];  // [i]: hits that took i probes, the last one takes longer ones
+    int miss_probes[TABLE_SIZE + 1];
+} InventoryLookupStats;
 
 // Main inventory structure containing both hash table and linked list
 typedef struct {
-    HashEntry entries[TABLE_SIZE];    // Hash table for O(1) lookups
+    NodeTable table;                 // Hash table for O(1) lookups, grows as needed
     InventoryNode* head;             // Head of sorted linked list
     InventoryNode* tail;             // Tail of sorted linked list
     int size;                        // Number of unique items
     SortCriterion current_sort;      // Current sort criterion
+    SortIndex sort_indexes[SORT_CRITERIA];  // Every node in each order, kept up by add and remove
+    bool indexed;                    // False if turned off or out of memory, sort_inventory sorts then
+    HashFunctionId hash_id;          // Hash used for the table
+    HashFunction hash;
+    uint64_t seed;
+    float reseed_threshold;          // Seeded hashes only, see add_item_to_inventory
+    int reseed_floor;                // No reseed until size gets past this
+    int reseeds;                     // Times the table was rebuilt under a new seed
+    BloomFilter filter;              // Off until enable_inventory_filter
+#ifdef INVENTORY_STATS
+    InventoryLookupStats lookup_stats;
+#endif
 } InventoryDatabase;
 
 // Core inventory functions
-uint32_t jenkins_hash(const char* item_name);
 void init_inventory_database(InventoryDatabase* db);
+void init_inventory_database_with_hash(InventoryDatabase* db, HashFunctionId hash_function, uint64_t seed);
+void free_inventory_database(InventoryDatabase* db);
+bool enable_inventory_filter(InventoryDatabase* db, int expected_items, double false_positive_rate);
+bool enable_inventory_indexes(InventoryDatabase* db);
+void disable_inventory_indexes(InventoryDatabase* db);
 bool add_item_to_inventory(InventoryDatabase* db, const Item* item, int quantity);
 bool remove_item_from_inventory(InventoryDatabase* db, const char* name, int quantity);
-InventoryNode* find_item(const InventoryDatabase* db, const char* name);
+// Not const: the filter and, with INVENTORY_STATS, the lookup counters move
+InventoryNode* find_item(InventoryDatabase* db, const char* name);
+int find_items(InventoryDatabase* db, const char* const names[], int n, InventoryNode* out[]);
+void inventory_probe_histogram(const InventoryDatabase* db, int histogram[], int buckets);
+void dump_inventory_stats(const InventoryDatabase* db, FILE* out, bool json);
 
 // Sort-related function declarations
 typedef int (*CompareFunction)(const InventoryNode*, const InventoryNode*);
+// Relinks the list in the order of the matching sort index, O(n) and no
+// comparisons. Without indexes (disable_inventory_indexes) it uses
+// key_sort_nodes, and the algorithms below if that runs out of memory.
 void sort_inventory(InventoryDatabase* db, CompareFunction compare_func);
 
 // Comparison function declarations
@@ -66,10 +114,18 @@ int compare_by_quantity(const InventoryNode* a, const InventoryNode* b);
 int compare_by_insertion_order(const InventoryNode* a, const InventoryNode* b);
 
 // Sorting algorithm declarations
+// quick_sort_nodes and heap_sort_nodes sort an array of the node pointers and
+// relink the list once, they fall back to merge_sort_nodes if it can't be allocated
 void bubble_sort_nodes(InventoryDatabase* db, CompareFunction compare_func);
 void quick_sort_nodes(InventoryDatabase* db, int low, int high, CompareFunction compare_func);
 void merge_sort_nodes(InventoryDatabase* db, InventoryNode** headRef, CompareFunction compare_func);
 void heap_sort_nodes(InventoryDatabase* db, InventoryNode** headRef,CompareFunction compare_func);
+// Sorts (key, node) pairs, the key packs the criterion and the insertion order
+// into one integer: same order as the sort indexes, ties go by insertion order.
+// Integer criteria with at most COUNTING_SORT_MAX_RANGE (inventory.c) values,
+// like rarity and quantity, get a stable counting sort in O(n), the rest a
+// quicksort. False if the pairs could not be allocated.
+bool key_sort_nodes(InventoryDatabase* db, SortCriterion criterion);
 
 
 // Display functions
@@ -0,0 +1,441 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inventory.h"
+#include "item_catalog.h"
+
+// Inventory regression tests, run by ctest. Each test returns the number of
+// checks that failed and prints what went wrong.
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// xorshift, so the items are the same on every platform
+static uint32_t next_random(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Items with few distinct values, so every criterion has plenty of ties.
+// Weights include 0 and -0, which compare equal.
+static void fill_inventory(InventoryDatabase* db, int n, uint32_t seed)
+{
+    uint32_t state = seed;
+    for (int i = 0; i < n; i++) {
+        Item item = {0};
+        snprintf(item.name, MAX_ITEM_NAME, "item_%d", i);
+        item.value = (int)(next_random(&state) % 50) - 10;
+        item.rarity = (enum Rarity)(next_random(&state) % 5);
+        item.weight = (float)((int)(next_random(&state) % 21) - 10) / 4.0f;
+        if (i % 7 == 0) item.weight = (i % 14 == 0) ? -0.0f : 0.0f;
+        add_item_to_inventory(db, &item, 1 + (int)(next_random(&state) % 30));
+    }
+}
+
+// prev and next agree, head and tail are the ends and every node is there once
+static int check_links(InventoryDatabase* db)
+{
+    int failures = 0;
+    int n = 0;
+    const InventoryNode* prev = NULL;
+    for (const InventoryNode* node = db->head; node != NULL && n <= db->size; node = node->next) {
+        CHECK(node->prev == prev);
+        CHECK(find_item(db, node->item.name) == node);
+        prev = node;
+        n++;
+    }
+    CHECK(n == db->size);
+    CHECK(db->tail == prev);
+    return failures;
+}
+
+// The list as an array, which has to hold db->size nodes
+static void list_nodes(const InventoryDatabase* db, InventoryNode* out[])
+{
+    int n = 0;
+    for (InventoryNode* node = db->head; node != NULL && n < db->size; node = node->next) {
+        out[n++] = node;
+    }
+}
+
+// What every criterion has to come out as: merge sort is stable, so from
+// insertion order it breaks ties by insertion order like the key sort does
+static void reference_order(InventoryDatabase* db, CompareFunction compare_func, InventoryNode* out[])
+{
+    merge_sort_nodes(db, &db->head, compare_by_insertion_order);
+    merge_sort_nodes(db, &db->head, compare_func);
+    list_nodes(db, out);
+}
+
+static const CompareFunction compares[SORT_CRITERIA] = {
+    [SORT_BY_VALUE] = compare_by_value,
+    [SORT_BY_RARITY] = compare_by_rarity,
+    [SORT_BY_WEIGHT] = compare_by_weight,
+    [SORT_BY_QUANTITY] = compare_by_quantity,
+    [SORT_BY_INSERTION_ORDER] = compare_by_insertion_order,
+};
+
+// Without indexes sort_inventory goes to key_sort_nodes, with them it relinks
+// from the index. Both have to give the comparator's order, ties by insertion.
+static int key_sort_matches_comparators(void)
+{
+    int failures = 0;
+    const int n = 3000;
+
+    InventoryDatabase db;
+    init_inventory_database(&db);
+    disable_inventory_indexes(&db);
+    CHECK(!db.indexed);
+    fill_inventory(&db, n, 0x12345678u);
+    CHECK(db.size == n);
+
+    InventoryNode** expected = malloc((size_t)n * sizeof(InventoryNode*));
+    InventoryNode** actual = malloc((size_t)n * sizeof(InventoryNode*));
+    CHECK(expected && actual);
+    if (!expected || !actual) {
+        free(expected);
+        free(actual);
+        free_inventory_database(&db);
+        return failures;
+    }
+
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        reference_order(&db, compares[c], expected);
+
+        // Start from some other order, so the sort has work to do
+        merge_sort_nodes(&db, &db.head, compares[(c + 1) % SORT_CRITERIA]);
+        sort_inventory(&db, compares[c]);
+        CHECK(db.current_sort == (SortCriterion)c);
+        failures += check_links(&db);
+        list_nodes(&db, actual);
+        CHECK(memcmp(expected, actual, (size_t)n * sizeof(InventoryNode*)) == 0);
+    }
+
+    CHECK(enable_inventory_indexes(&db));
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        reference_order(&db, compares[c], expected);
+
+        merge_sort_nodes(&db, &db.head, compares[(c + 1) % SORT_CRITERIA]);
+        sort_inventory(&db, compares[c]);
+        CHECK(db.current_sort == (SortCriterion)c);
+        failures += check_links(&db);
+        list_nodes(&db, actual);
+        CHECK(memcmp(expected, actual, (size_t)n * sizeof(InventoryNode*)) == 0);
+    }
+
+    free(expected);
+    free(actual);
+    free_inventory_database(&db);
+    return failures;
+}
+
+// Quantities spread over `range` values, with both ends there, sorted by
+// key_sort_nodes from insertion order and from some other order. Up to
+// COUNTING_SORT_MAX_RANGE (1024) values it counts, one more and it quicksorts,
+// and both have to put ties in insertion order.
+static int quantity_sort_at_range(int range)
+{
+    int failures = 0;
+    const int n = 4000;
+
+    InventoryDatabase db;
+    init_inventory_database(&db);
+    disable_inventory_indexes(&db);
+
+    uint32_t state = 0x9abcdef1u;
+    for (int i = 0; i < n; i++) {
+        Item item = {0};
+        snprintf(item.name, MAX_ITEM_NAME, "item_%d", i);
+        int quantity = 1 + (int)(next_random(&state) % (uint32_t)range);
+        if (i == 0) quantity = 1;
+        if (i == 1) quantity = range;
+        CHECK(add_item_to_inventory(&db, &item, quantity));
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) merge_sort_nodes(&db, &db.head, compare_by_value);
+
+        CHECK(key_sort_nodes(&db, SORT_BY_QUANTITY));
+        failures += check_links(&db);
+        CHECK(db.head->quantity == range);
+        CHECK(db.tail->quantity == 1);
+        for (const InventoryNode* node = db.head; node && node->next; node = node->next) {
+            const InventoryNode* next = node->next;
+            CHECK(node->quantity >= next->quantity);
+            if (node->quantity == next->quantity) CHECK(node->insertion_order < next->insertion_order);
+        }
+    }
+
+    free_inventory_database(&db);
+    return failures;
+}
+
+// Every node is in order by compare_func, ties in any order
+static int check_sorted(const InventoryDatabase* db, CompareFunction compare_func)
+{
+    int failures = 0;
+    for (const InventoryNode* node = db->head; node && node->next; node = node->next) {
+        CHECK(compare_func(node, node->next) <= 0);
+    }
+    return failures;
+}
+
+// Quick, merge and heap sort each criterion, then quicksort only the middle
+// of the list: the list has to stay whole and the ends where they were
+static int comparator_sorts_keep_links(void)
+{
+    int failures = 0;
+    const int n = 2000;
+
+    InventoryDatabase db;
+    init_inventory_database(&db);
+    fill_inventory(&db, n, 0x0badf00du);
+
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        merge_sort_nodes(&db, &db.head, compares[(c + 1) % SORT_CRITERIA]);
+        quick_sort_nodes(&db, 0, db.size - 1, compares[c]);
+        failures += check_links(&db);
+        failures += check_sorted(&db, compares[c]);
+
+        merge_sort_nodes(&db, &db.head, compares[(c + 1) % SORT_CRITERIA]);
+        merge_sort_nodes(&db, &db.head, compares[c]);
+        failures += check_links(&db);
+        failures += check_sorted(&db, compares[c]);
+
+        merge_sort_nodes(&db, &db.head, compares[(c + 1) % SORT_CRITERIA]);
+        heap_sort_nodes(&db, &db.head, compares[c]);
+        failures += check_links(&db);
+        failures += check_sorted(&db, compares[c]);
+    }
+
+    InventoryNode** before = malloc((size_t)n * sizeof(InventoryNode*));
+    InventoryNode** after = malloc((size_t)n * sizeof(InventoryNode*));
+    CHECK(before && after);
+    if (before && after) {
+        const int low = 100;
+        const int high = 1500;
+        merge_sort_nodes(&db, &db.head, compare_by_insertion_order);
+        list_nodes(&db, before);
+        quick_sort_nodes(&db, low, high, compare_by_value);
+        failures += check_links(&db);
+        list_nodes(&db, after);
+
+        CHECK(memcmp(before, after, (size_t)low * sizeof(InventoryNode*)) == 0);
+        CHECK(memcmp(before + high + 1, after + high + 1, (size_t)(n - high - 1) * sizeof(InventoryNode*)) == 0);
+        for (int i = low; i < high; i++) CHECK(compare_by_value(after[i], after[i + 1]) <= 0);
+    }
+
+    free(before);
+    free(after);
+    free_inventory_database(&db);
+    return failures;
+}
+
+// Bubble sort relinks neighbours instead of swapping their items, which has
+// to get head and tail right when the swap is at either end. Sizes from two
+// up, started reversed so the first and last nodes move.
+static int bubble_sort_relinks(void)
+{
+    int failures = 0;
+
+    for (int n = 2; n <= 200; n += (n < 8) ? 1 : 48) {
+        InventoryDatabase db;
+        init_inventory_database(&db);
+        fill_inventory(&db, n, 0x5eed0000u + (uint32_t)n);
+
+        for (int c = 0; c < SORT_CRITERIA; c++) {
+            merge_sort_nodes(&db, &db.head, compare_by_insertion_order);
+            InventoryNode* first = db.head;
+            InventoryNode* last = db.tail;
+            bubble_sort_nodes(&db, compares[c]);
+            failures += check_links(&db);
+            failures += check_sorted(&db, compares[c]);
+            // Nodes keep their items, the name table still finds the same ones
+            CHECK(find_item(&db, first->item.name) == first);
+            CHECK(find_item(&db, last->item.name) == last);
+        }
+
+        // Reversed insertion order, every pair gets swapped
+        for (InventoryNode* node = db.head; node; node = node->prev) {
+            InventoryNode* temp = node->next;
+            node->next = node->prev;
+            node->prev = temp;
+        }
+        InventoryNode* temp = db.head;
+        db.head = db.tail;
+        db.tail = temp;
+        bubble_sort_nodes(&db, compare_by_insertion_order);
+        failures += check_links(&db);
+        for (const InventoryNode* node = db.head; node && node->next; node = node->next) {
+            CHECK(node->insertion_order < node->next->insertion_order);
+        }
+
+        free_inventory_database(&db);
+    }
+    return failures;
+}
+
+// Each index holds every node once, in the order merge sort gives its
+// criterion, and sort_inventory relinks the list to match
+static int check_indexes(InventoryDatabase* db, InventoryNode* expected[], InventoryNode* actual[])
+{
+    int failures = 0;
+    CHECK(db->indexed);
+
+    for (int c = 0; c < SORT_CRITERIA; c++) {
+        reference_order(db, compares[c], expected);
+
+        const SortIndex* index = &db->sort_indexes[c];
+        CHECK(index->count == db->size);
+        int i = 0;
+        for (const SortIndexEntry* entry = sort_index_first(index); entry && i < db->size; entry = entry->next[0]) {
+            CHECK(entry->node == expected[i]);
+            i++;
+        }
+        CHECK(i == db->size);
+
+        merge_sort_nodes(db, &db->head, compares[(c + 1) % SORT_CRITERIA]);
+        sort_inventory(db, compares[c]);
+        CHECK(db->current_sort == (SortCriterion)c);
+        failures += check_links(db);
+        list_nodes(db, actual);
+        CHECK(memcmp(expected, actual, (size_t)db->size * sizeof(InventoryNode*)) == 0);
+    }
+    return failures;
+}
+
+// Adds, adds to items already there, partial and whole removals, with the
+// indexes checked along the way. Quantity is the key that moves in place.
+static int indexes_follow_adds_and_removes(void)
+{
+    int failures = 0;
+    const int names = 1200;
+
+    InventoryNode** expected = malloc((size_t)names * sizeof(InventoryNode*));
+    InventoryNode** actual = malloc((size_t)names * sizeof(InventoryNode*));
+    CHECK(expected && actual);
+    if (!expected || !actual) {
+        free(expected);
+        free(actual);
+        return failures;
+    }
+
+    InventoryDatabase db;
+    init_inventory_database(&db);
+    fill_inventory(&db, names / 2, 0x31415926u);
+    failures += check_indexes(&db, expected, actual);
+
+    uint32_t state = 0x27182818u;
+    for (int op = 1; op <= 6000; op++) {
+        Item item = {0};
+        snprintf(item.name, MAX_ITEM_NAME, "item_%d", (int)(next_random(&state) % (uint32_t)names));
+        InventoryNode* node = find_item(&db, item.name);
+        int size = db.size;
+
+        switch (next_random(&state) % 4) {
+            case 0:
+                item.value = (int)(next_random(&state) % 50);
+                item.rarity = (enum Rarity)(next_random(&state) % 5);
+                item.weight = (float)(next_random(&state) % 40) / 4.0f;
+                CHECK(add_item_to_inventory(&db, &item, 1 + (int)(next_random(&state) % 5)));
+                CHECK(db.size == size + (node ? 0 : 1));
+                break;
+            case 1:
+            case 2:
+                if (node && node->quantity > 1) {
+                    int quantity = node->quantity;
+                    CHECK(remove_item_from_inventory(&db, item.name, 1 + (int)(next_random(&state) % (uint32_t)(quantity - 1))));
+                    CHECK(find_item(&db, item.name) == node);
+                    CHECK(node->quantity < quantity);
+                    CHECK(db.size == size);
+                }
+                break;
+            case 3:
+                if (node) {
+                    CHECK(!remove_item_from_inventory(&db, item.name, node->quantity + 1));
+                    CHECK(remove_item_from_inventory(&db, item.name, node->quantity));
+                    CHECK(find_item(&db, item.name) == NULL);
+                    CHECK(db.size == size - 1);
+                }
+                break;
+        }
+
+        if (op % 1000 == 0) failures += check_indexes(&db, expected, actual);
+    }
+
+    // Indexes turned on again later are built from the nodes there
+    disable_inventory_indexes(&db);
+    CHECK(db.head != NULL);
+    if (db.head) CHECK(remove_item_from_inventory(&db, db.head->item.name, db.head->quantity));
+    CHECK(enable_inventory_indexes(&db));
+    failures += check_indexes(&db, expected, actual);
+
+    free(expected);
+    free(actual);
+    free_inventory_database(&db);
+    return failures;
+}
+
+// The perfect hash maps every name to its place in items[], which main.c
+// uses to pick the icon. Both come from item_list.h, this checks they agree.
+static int catalog_matches_items(void)
+{
+    int failures = 0;
+
+    CHECK(catalog_item_count == ITEM_COUNT);
+    for (int i = 0; i < ITEM_COUNT; i++) {
+        CHECK(find_catalog_index(items[i].name) == i);
+        CHECK(find_catalog_item(items[i].name) == &items[i]);
+    }
+    CHECK(find_catalog_index("Spoon") == -1);
+    CHECK(find_catalog_item("") == NULL);
+    return failures;
+}
+
+// A reseed that does not help, here forced by a threshold every table is
+// over, must not be retried until the inventory has doubled, so n adds
+// rebuild the table about log2(n) times instead of on every scan
+static int reseeds_back_off(void)
+{
+    int failures = 0;
+    const int n = 1024;
+
+    InventoryDatabase db;
+    init_inventory_database(&db);
+    db.reseed_threshold = 0.0f;
+    fill_inventory(&db, n, 7);
+    CHECK(db.size == n);
+    CHECK(db.reseeds > 0 && db.reseeds <= 11);
+    failures += check_links(&db);
+    free_inventory_database(&db);
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    failures += catalog_matches_items();
+    failures += comparator_sorts_keep_links();
+    failures += bubble_sort_relinks();
+    failures += key_sort_matches_comparators();
+    failures += indexes_follow_adds_and_removes();
+    failures += reseeds_back_off();
+    failures += quantity_sort_at_range(1024);
+    failures += quantity_sort_at_range(1025);
+
+    if (failures) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All inventory tests passed\n");
+    return 0;
+}
@@ -2,6 +2,7 @@
 #define LAB_0X11H_ITEM_H
 
 #include <raylib.h>
+#include "item_list.h"
 #define MAX_ITEM_NAME 32
 
 enum Rarity {
@@ -20,10 +21,18 @@ typedef struct {
     float weight;
 } Item;
 
-// Global items array
-extern Item items[10];
+// Catalog items by their place in item_list.h
+#define ITEM_ENUM(id, ...) id,
+enum Item_Name {
+    ITEM_LIST(ITEM_ENUM)
+    ITEM_COUNT
+};
+
+// Global items array, indexed by enum Item_Name
+extern Item items[ITEM_COUNT];
 
 void InitItems(void);
 void CleanupItems(void);
+Item* find_catalog_item(const char* name);
 
 #endif //LAB_0X11H_ITEM_H
\ No newline at end of file
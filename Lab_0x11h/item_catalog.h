@@ -0,0 +1,15 @@
+#ifndef LAB_0X11H_ITEM_CATALOG_H
+#define LAB_0X11H_ITEM_CATALOG_H
+
+#include "Hash.h"
+
+// Names of the items in items[], listed in item_list.h
+// catalog_names writes them to items.catalog in enum Item_Name order, and
+// item_catalog.c is generated from that by PerfectHashGen: a minimal perfect
+// hash, so a lookup is one hash, one slot and one strcmp.
+extern const int catalog_item_count;
+
+// Index of the name in items[] (and enum Item_Name), -1 if it is not there
+int find_catalog_index(const char* name);
+
+#endif //LAB_0X11H_ITEM_CATALOG_H
@@ -0,0 +1,20 @@
+#ifndef LAB_0X11H_ITEM_LIST_H
+#define LAB_0X11H_ITEM_LIST_H
+
+// Every catalog item, once. enum Item_Name, items[] in item.c, the icons in
+// main.c and the names catalog the perfect hash is generated from are all
+// expanded from this list, so their orders cannot drift apart.
+// X(id, name, icon file, value, rarity, weight)
+#define ITEM_LIST(X) \
+    X(SWORD,    "Sword",    "sword.png",    100, COMMON,    2.5f) \
+    X(SHIELD,   "Shield",   "shield.png",   150, UNCOMMON,  5.0f) \
+    X(BOW,      "Bow",      "bow.png",      200, RARE,      1.5f) \
+    X(AXE,      "Axe",      "axe.png",      250, EPIC,      3.0f) \
+    X(STAFF,    "Staff",    "staff.png",    300, LEGENDARY, 2.0f) \
+    X(DAGGER,   "Dagger",   "dagger.png",   50,  COMMON,    1.0f) \
+    X(MACE,     "Mace",     "mace.png",     75,  UNCOMMON,  3.5f) \
+    X(GREATAXE, "GreatAxe", "greataxe.png", 125, RARE,      4.0f) \
+    X(CROSSBOW, "Crossbow", "crossbow.png", 175, EPIC,      2.5f) \
+    X(CLOAK,    "Cloak",    "cloak.png",    225, LEGENDARY, 1.0f)
+
+#endif //LAB_0X11H_ITEM_LIST_H
@@ -2,21 +2,9 @@
 #include <string.h>
 #include "inventory.h"
 #include "item.h"
+#include "item_catalog.h"
 #include "raylib.h"
 
-enum Item_Name {
-    SWORD,
-    SHIELD,
-    BOW,
-    AXE,
-    STAFF,
-    DAGGER,
-    MACE,
-    GREATAXE,
-    CROSSBOW,
-    CLOAK
-};
-
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
 #define ICON_SIZE 64
@@ -28,21 +16,17 @@ typedef struct {
     Texture2D iconTexture;
 } ItemIcon;
 
-ItemIcon itemIcons[10];  // One for each enum Item_Name
+ItemIcon itemIcons[ITEM_COUNT];  // One for each enum Item_Name
 Texture2D blankIcon;
 
+#define ICON_FILE(id, name, icon, ...) [id] = "icons/" icon,
+static const char* const icon_files[ITEM_COUNT] = { ITEM_LIST(ICON_FILE) };
+
 void LoadItemIcons() {
     // Load all item icons
-    itemIcons[SWORD].iconTexture = LoadTexture("icons/sword.png");
-    itemIcons[SHIELD].iconTexture = LoadTexture("icons/shield.png");
-    itemIcons[BOW].iconTexture = LoadTexture("icons/bow.png");
-    itemIcons[AXE].iconTexture = LoadTexture("icons/axe.png");
-    itemIcons[STAFF].iconTexture = LoadTexture("icons/staff.png");
-    itemIcons[DAGGER].iconTexture = LoadTexture("icons/dagger.png");
-    itemIcons[MACE].iconTexture = LoadTexture("icons/mace.png");
-    itemIcons[GREATAXE].iconTexture = LoadTexture("icons/greataxe.png");
-    itemIcons[CROSSBOW].iconTexture = LoadTexture("icons/crossbow.png");
-    itemIcons[CLOAK].iconTexture = LoadTexture("icons/cloak.png");
+    for (int i = 0; i < ITEM_COUNT; i++) {
+        itemIcons[i].iconTexture = LoadTexture(icon_files[i]);
+    }
 
     // Load blank icon for empty slots
     blankIcon = LoadTexture("icons/blank.png");
@@ -50,7 +34,7 @@ void LoadItemIcons() {
 
 void UnloadItemIcons() {
     // Unload all item icons
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < ITEM_COUNT; i++) {
         UnloadTexture(itemIcons[i].iconTexture);
     }
     UnloadTexture(blankIcon);
@@ -81,13 +65,7 @@ void DrawInventory(InventoryDatabase* inventory) {
             // If we have an item to draw
             if (current != NULL) {
                 // Find the corresponding enum value for the item
-                int itemEnum = -1;
-                for (int i = 0; i < 10; i++) {
-                    if (strcmp(current->name, items[i].name) == 0) {
-                        itemEnum = i;
-                        break;
-                    }
-                }
+                int itemEnum = find_catalog_index(current->item.name);
 
                 if (itemEnum != -1) {
                     DrawTexture(itemIcons[itemEnum].iconTexture, x, y, WHITE);
@@ -115,6 +93,7 @@ int main() {
     // Initialize inventory
     InventoryDatabase inventory;
     init_inventory_database(&inventory);
+    enable_inventory_filter(&inventory, TABLE_SIZE, 0.01);
 
     // Load icons
     LoadItemIcons();
@@ -137,6 +116,7 @@ int main() {
     }
 
     // Cleanup
+    free_inventory_database(&inventory);
     UnloadItemIcons();
     CloseWindow();
 
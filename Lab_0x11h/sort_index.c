@@ -0,0 +1,123 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "sort_index.h"
+
+static SortIndexEntry* alloc_entry(int level) {
+    SortIndexEntry* entry = malloc(sizeof(SortIndexEntry) + (size_t)level * sizeof(SortIndexEntry*));
+    if (!entry) return NULL;
+
+    entry->node = NULL;
+    entry->level = level;
+    memset(entry->next, 0, (size_t)level * sizeof(SortIndexEntry*));
+    return entry;
+}
+
+// xorshift, each level up is taken with chance 1 / SORT_INDEX_BRANCHING
+static int random_level(SortIndex* index) {
+    int level = 1;
+    for (;;) {
+        uint32_t x = index->random_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        index->random_state = x;
+
+        if (level >= SORT_INDEX_MAX_LEVEL || x % SORT_INDEX_BRANCHING != 0) return level;
+        level++;
+    }
+}
+
+bool init_sort_index(SortIndex* index, SortIndexCompare compare) {
+    if (!index || !compare) return false;
+
+    *index = (SortIndex){0};
+    index->head = alloc_entry(SORT_INDEX_MAX_LEVEL);
+    if (!index->head) return false;
+
+    index->level = 1;
+    index->random_state = 0x9E3779B9u ^ (uint32_t)(uintptr_t)index;
+    if (index->random_state == 0) index->random_state = 1;
+    index->compare = compare;
+    return true;
+}
+
+void free_sort_index(SortIndex* index) {
+    if (!index) return;
+
+    SortIndexEntry* entry = index->head;
+    while (entry) {
+        SortIndexEntry* next = entry->next[0];
+        free(entry);
+        entry = next;
+    }
+    *index = (SortIndex){0};
+}
+
+/* Fill update[l] with the last entry on level l that sorts before `node`, the
+ * head if none does, going down one level each time the next entry would pass
+ * it. Returns the entry that sorts right after, which is the node's own entry
+ * when it is in the index.
+ */
+static SortIndexEntry* find_before(const SortIndex* index, const struct InventoryNode* node,
+                                   SortIndexEntry* update[]) {
+    SortIndexEntry* entry = index->head;
+    for (int l = index->level - 1; l >= 0; l--) {
+        while (entry->next[l] && index->compare(entry->next[l]->node, node) < 0) {
+            entry = entry->next[l];
+        }
+        update[l] = entry;
+    }
+    return entry->next[0];
+}
+
+void sort_index_attach(SortIndex* index, SortIndexEntry* entry) {
+    SortIndexEntry* update[SORT_INDEX_MAX_LEVEL];
+    find_before(index, entry->node, update);
+
+    // Levels nobody used yet start at the head
+    for (int l = index->level; l < entry->level; l++) update[l] = index->head;
+    if (entry->level > index->level) index->level = entry->level;
+
+    for (int l = 0; l < entry->level; l++) {
+        entry->next[l] = update[l]->next[l];
+        update[l]->next[l] = entry;
+    }
+    index->count++;
+}
+
+SortIndexEntry* sort_index_detach(SortIndex* index, const struct InventoryNode* node) {
+    if (!index || !index->head || !node) return NULL;
+
+    SortIndexEntry* update[SORT_INDEX_MAX_LEVEL];
+    SortIndexEntry* entry = find_before(index, node, update);
+    if (!entry || entry->node != node) return NULL;
+
+    for (int l = 0; l < entry->level; l++) {
+        update[l]->next[l] = entry->next[l];
+    }
+    while (index->level > 1 && index->head->next[index->level - 1] == NULL) {
+        index->level--;
+    }
+    index->count--;
+    return entry;
+}
+
+bool sort_index_insert(SortIndex* index, struct InventoryNode* node) {
+    if (!index || !index->head || !node) return false;
+
+    SortIndexEntry* entry = alloc_entry(random_level(index));
+    if (!entry) return false;
+
+    entry->node = node;
+    sort_index_attach(index, entry);
+    return true;
+}
+
+bool sort_index_remove(SortIndex* index, const struct InventoryNode* node) {
+    SortIndexEntry* entry = sort_index_detach(index, node);
+    if (!entry) return false;
+
+    free(entry);
+    return true;
+}
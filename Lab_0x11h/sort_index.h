@@ -0,0 +1,51 @@
+#ifndef LAB_0X11H_SORT_INDEX_H
+#define LAB_0X11H_SORT_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Inventory nodes kept in one sort order as they come and go: a skip list.
+// Every entry is on the bottom level, which is the whole order, and on each
+// level above with probability 1/SORT_INDEX_BRANCHING, so an insert or a
+// removal steps over O(log n) entries to find its place. The index only holds
+// node pointers and orders them with its compare function, which has to give
+// every node its own place (break ties on insertion order, say).
+#define SORT_INDEX_MAX_LEVEL 16      // Plenty for 4^16 entries
+#define SORT_INDEX_BRANCHING 4
+
+struct InventoryNode;
+typedef int (*SortIndexCompare)(const struct InventoryNode*, const struct InventoryNode*);
+
+typedef struct SortIndexEntry {
+    struct InventoryNode* node;
+    int level;                       // Levels this entry is linked on
+    struct SortIndexEntry* next[];   // next[0] is the following node in order
+} SortIndexEntry;
+
+typedef struct {
+    SortIndexEntry* head;            // Sentinel with every level, head->next[0] is the first entry
+    int level;                       // Levels in use
+    int count;
+    uint32_t random_state;           // Picks entry levels
+    SortIndexCompare compare;
+} SortIndex;
+
+bool init_sort_index(SortIndex* index, SortIndexCompare compare);
+void free_sort_index(SortIndex* index);
+
+// False if memory ran out, the index is unchanged then
+bool sort_index_insert(SortIndex* index, struct InventoryNode* node);
+// The node has to compare the way it did when it went in
+bool sort_index_remove(SortIndex* index, const struct InventoryNode* node);
+
+// For a node whose sort key is about to change: take its entry out, change
+// the node, then put the same entry back. Neither step allocates.
+SortIndexEntry* sort_index_detach(SortIndex* index, const struct InventoryNode* node);
+void sort_index_attach(SortIndex* index, SortIndexEntry* entry);
+
+// First entry in order, walk on with entry->next[0]
+static inline SortIndexEntry* sort_index_first(const SortIndex* index) {
+    return index->head ? index->head->next[0] : NULL;
+}
+
+#endif //LAB_0X11H_SORT_INDEX_H